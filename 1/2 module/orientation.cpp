@@ -0,0 +1,97 @@
+#include "orientation.h"
+#include <cmath>
+
+namespace {
+    const double kEpsilon = 1.1102230246251565e-16;
+    const double kOrient2DBound = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+
+    void TwoSum(double a, double b, double& sum, double& error) {
+        sum = a + b;
+        const double bVirtual = sum - a;
+        const double aVirtual = sum - bVirtual;
+        error = (a - aVirtual) + (b - bVirtual);
+    }
+
+    void FastTwoSum(double a, double b, double& sum, double& error) {
+        sum = a + b;
+        error = b - (sum - a);
+    }
+
+    void TwoProduct(double a, double b, double& product, double& error) {
+        product = a * b;
+        error = std::fma(a, b, -product);
+    }
+}
+
+double Orientation::Orient2D(double ax, double ay, double bx, double by, double cx, double cy) {
+    const double left = (ax - cx) * (by - cy);
+    const double right = (ay - cy) * (bx - cx);
+    const double determinant = left - right;
+    const double bound = kOrient2DBound * (std::abs(left) + std::abs(right));
+
+    if (determinant > bound || -determinant > bound) {
+        return determinant;
+    }
+    return Orient2DExact(ax, ay, bx, by, cx, cy);
+}
+
+double Orientation::Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy) {
+    Expansion determinant = Multiply(Difference(ax, cx), Difference(by, cy));
+    for (double term : Multiply(Difference(ay, cy), Difference(bx, cx))) {
+        determinant = Grow(determinant, -term);
+    }
+
+    double estimate = 0.0;
+    for (double term : determinant) {
+        estimate += term;
+    }
+    return estimate;
+}
+
+Orientation::Expansion Orientation::Difference(double a, double b) {
+    double sum, error;
+    TwoSum(a, -b, sum, error);
+    Expansion result;
+    if (error != 0.0) result.push_back(error);
+    if (sum != 0.0 || result.empty()) result.push_back(sum);
+    return result;
+}
+
+Orientation::Expansion Orientation::Grow(const Expansion& e, double b) {
+    Expansion result;
+    double q = b;
+    for (double term : e) {
+        double error;
+        TwoSum(q, term, q, error);
+        if (error != 0.0) result.push_back(error);
+    }
+    if (q != 0.0 || result.empty()) result.push_back(q);
+    return result;
+}
+
+Orientation::Expansion Orientation::Scale(const Expansion& e, double b) {
+    Expansion result;
+    double q, error;
+    TwoProduct(e[0], b, q, error);
+    if (error != 0.0) result.push_back(error);
+    for (size_t i = 1; i < e.size(); ++i) {
+        double product, productError, sum;
+        TwoProduct(e[i], b, product, productError);
+        TwoSum(q, productError, sum, error);
+        if (error != 0.0) result.push_back(error);
+        FastTwoSum(product, sum, q, error);
+        if (error != 0.0) result.push_back(error);
+    }
+    if (q != 0.0 || result.empty()) result.push_back(q);
+    return result;
+}
+
+Orientation::Expansion Orientation::Multiply(const Expansion& e, const Expansion& f) {
+    Expansion result{0.0};
+    for (double factor : f) {
+        for (double term : Scale(e, factor)) {
+            result = Grow(result, term);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,23 @@
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+
+#include <vector>
+
+// Robust orientation test (Shewchuk-style): a cheap floating-point filter,
+// exact expansion arithmetic only when the sign is in doubt
+class Orientation {
+public:
+    // > 0 if A, B, C are counterclockwise, < 0 if clockwise, exactly 0 if collinear
+    static double Orient2D(double ax, double ay, double bx, double by, double cx, double cy);
+
+private:
+    using Expansion = std::vector<double>;
+
+    static double Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy);
+    static Expansion Difference(double a, double b);
+    static Expansion Grow(const Expansion& e, double b);
+    static Expansion Scale(const Expansion& e, double b);
+    static Expansion Multiply(const Expansion& e, const Expansion& f);
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "triangle_area_calculator.h"
 #include "system_info.h"
+#include "orientation.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -53,10 +54,11 @@ bool TriangleAreaCalculator::ValidateInput() const {
         return false;
     }
     
-    double determinant = (m_secondVertexX - m_firstVertexX) * (m_thirdVertexY - m_firstVertexY) 
-                       - (m_thirdVertexX - m_firstVertexX) * (m_secondVertexY - m_firstVertexY);
+    const double orientation = Orientation::Orient2D(m_firstVertexX, m_firstVertexY,
+                                                     m_secondVertexX, m_secondVertexY,
+                                                     m_thirdVertexX, m_thirdVertexY);
     
-    if (std::abs(determinant) < 1e-10) {
+    if (orientation == 0.0) {
         std::cout << "ERROR: Points are collinear - cannot form a triangle." << std::endl;
         return false;
     }
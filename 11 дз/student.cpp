@@ -4,6 +4,34 @@
 #include <vector>
 #include <utility>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <future>
+#include <chrono>
+#include <memory>
+#include <charconv>
+#include <string_view>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 // ------------------------------------------------------------
 // Data Structures
@@ -75,243 +103,2025 @@ bool Student::operator<(const Student& other) const
     return calculate_total_score() < other.calculate_total_score();
 }
 
-bool Student::operator>(const Student& other) const 
+bool Student::operator>(const Student& other) const 
+{
+    return calculate_total_score() > other.calculate_total_score();
+}
+
+// ------------------------------------------------------------
+// Sort Engine
+// ------------------------------------------------------------
+
+const size_t INSERTION_SORT_THRESHOLD = 24;
+const size_t NINTHER_THRESHOLD = 128;
+const size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+const size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+template <typename Iter, typename Compare>
+void insertion_sort_range(Iter first, Iter last, Compare comp)
+{
+    if (first == last) return;
+
+    for (Iter current = first + 1; current != last; ++current) 
+    {
+        Iter sift = current;
+        Iter sift_prev = current - 1;
+
+        if (comp(*sift, *sift_prev)) 
+        {
+            auto temp = std::move(*sift);
+            do 
+            {
+                *sift-- = std::move(*sift_prev);
+            } while (sift != first && comp(temp, *--sift_prev));
+            *sift = std::move(temp);
+        }
+    }
+}
+
+// Requires an element not greater than everything in [first, last) right before first
+template <typename Iter, typename Compare>
+void unguarded_insertion_sort_range(Iter first, Iter last, Compare comp)
+{
+    if (first == last) return;
+
+    for (Iter current = first + 1; current != last; ++current) 
+    {
+        Iter sift = current;
+        Iter sift_prev = current - 1;
+
+        if (comp(*sift, *sift_prev)) 
+        {
+            auto temp = std::move(*sift);
+            do 
+            {
+                *sift-- = std::move(*sift_prev);
+            } while (comp(temp, *--sift_prev));
+            *sift = std::move(temp);
+        }
+    }
+}
+
+// Gives up once too many elements had to be moved; true means the range is sorted
+template <typename Iter, typename Compare>
+bool partial_insertion_sort_range(Iter first, Iter last, Compare comp)
+{
+    if (first == last) return true;
+
+    size_t moved = 0;
+    for (Iter current = first + 1; current != last; ++current) 
+    {
+        Iter sift = current;
+        Iter sift_prev = current - 1;
+
+        if (comp(*sift, *sift_prev)) 
+        {
+            auto temp = std::move(*sift);
+            do 
+            {
+                *sift-- = std::move(*sift_prev);
+            } while (sift != first && comp(temp, *--sift_prev));
+            *sift = std::move(temp);
+            moved += static_cast<size_t>(current - sift);
+        }
+
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) return false;
+    }
+
+    return true;
+}
+
+template <typename Iter, typename Compare>
+void sort_three(Iter a, Iter b, Iter c, Compare comp)
+{
+    if (comp(*b, *a)) std::iter_swap(a, b);
+    if (comp(*c, *b)) std::iter_swap(b, c);
+    if (comp(*b, *a)) std::iter_swap(a, b);
+}
+
+// Pivot is *first; elements equal to the pivot go to the right part
+template <typename Iter, typename Compare>
+std::pair<Iter, bool> partition_right(Iter first, Iter last, Compare comp)
+{
+    auto pivot = std::move(*first);
+    Iter left = first;
+    Iter right = last;
+
+    while (comp(*++left, pivot));
+
+    if (left - 1 == first) 
+    {
+        while (left < right && !comp(*--right, pivot));
+    }
+    else 
+    {
+        while (!comp(*--right, pivot));
+    }
+
+    const bool already_partitioned = left >= right;
+
+    while (left < right) 
+    {
+        std::iter_swap(left, right);
+        while (comp(*++left, pivot));
+        while (!comp(*--right, pivot));
+    }
+
+    Iter pivot_position = left - 1;
+    *first = std::move(*pivot_position);
+    *pivot_position = std::move(pivot);
+    return std::make_pair(pivot_position, already_partitioned);
+}
+
+// Pivot is *first; elements equal to the pivot go to the left part
+template <typename Iter, typename Compare>
+Iter partition_left(Iter first, Iter last, Compare comp)
+{
+    auto pivot = std::move(*first);
+    Iter left = first;
+    Iter right = last;
+
+    while (comp(pivot, *--right));
+
+    if (right + 1 == last) 
+    {
+        while (left < right && !comp(pivot, *++left));
+    }
+    else 
+    {
+        while (!comp(pivot, *++left));
+    }
+
+    while (left < right) 
+    {
+        std::iter_swap(left, right);
+        while (comp(pivot, *--right));
+        while (!comp(pivot, *++left));
+    }
+
+    *first = std::move(*right);
+    *right = std::move(pivot);
+    return right;
+}
+
+// Pattern-defeating quicksort: sorted and reversed runs finish in linear time,
+// many equal keys are split off in one pass, adversarial inputs fall back to heapsort
+template <typename Iter, typename Compare>
+void pdq_sort_loop(Iter first, Iter last, Compare comp, int bad_allowed, bool leftmost = true)
+{
+    while (true) 
+    {
+        const size_t size = static_cast<size_t>(last - first);
+
+        if (size < INSERTION_SORT_THRESHOLD) 
+        {
+            if (leftmost) 
+            {
+                insertion_sort_range(first, last, comp);
+            }
+            else 
+            {
+                unguarded_insertion_sort_range(first, last, comp);
+            }
+            return;
+        }
+
+        const size_t half = size / 2;
+        if (size > NINTHER_THRESHOLD) 
+        {
+            sort_three(first, first + half, last - 1, comp);
+            sort_three(first + 1, first + (half - 1), last - 2, comp);
+            sort_three(first + 2, first + (half + 1), last - 3, comp);
+            sort_three(first + (half - 1), first + half, first + (half + 1), comp);
+            std::iter_swap(first, first + half);
+        }
+        else 
+        {
+            sort_three(first + half, first, last - 1, comp);
+        }
+
+        // The element before the range is not less than the pivot: everything equal to it is already in place
+        if (!leftmost && !comp(*(first - 1), *first)) 
+        {
+            first = partition_left(first, last, comp) + 1;
+            continue;
+        }
+
+        const std::pair<Iter, bool> partition = partition_right(first, last, comp);
+        const Iter pivot_position = partition.first;
+        const size_t left_size = static_cast<size_t>(pivot_position - first);
+        const size_t right_size = static_cast<size_t>(last - (pivot_position + 1));
+
+        if (left_size < size / 8 || right_size < size / 8) 
+        {
+            if (--bad_allowed == 0) 
+            {
+                std::make_heap(first, last, comp);
+                std::sort_heap(first, last, comp);
+                return;
+            }
+
+            if (left_size >= INSERTION_SORT_THRESHOLD) 
+            {
+                std::iter_swap(first, first + left_size / 4);
+                std::iter_swap(pivot_position - 1, pivot_position - left_size / 4);
+            }
+
+            if (right_size >= INSERTION_SORT_THRESHOLD) 
+            {
+                std::iter_swap(pivot_position + 1, pivot_position + (1 + right_size / 4));
+                std::iter_swap(last - 1, last - right_size / 4);
+            }
+        }
+        else if (partition.second 
+                 && partial_insertion_sort_range(first, pivot_position, comp)
+                 && partial_insertion_sort_range(pivot_position + 1, last, comp)) 
+        {
+            return;
+        }
+
+        pdq_sort_loop(first, pivot_position, comp, bad_allowed, leftmost);
+        first = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+template <typename Iter, typename Compare>
+void pdq_sort(Iter first, Iter last, Compare comp)
+{
+    if (last - first < 2) return;
+
+    int bad_allowed = 1;
+    for (size_t size = static_cast<size_t>(last - first); size > 1; size >>= 1) 
+    {
+        ++bad_allowed;
+    }
+
+    pdq_sort_loop(first, last, comp, bad_allowed);
+}
+
+// Every thread sorts its own chunk, then neighbouring runs are merged pairwise in parallel
+template <typename Iter, typename Compare>
+void parallel_merge_sort(Iter first, Iter last, Compare comp, size_t thread_count)
+{
+    using Value = typename std::iterator_traits<Iter>::value_type;
+
+    const size_t size = static_cast<size_t>(last - first);
+    size_t chunk_count = 1;
+    while (chunk_count * 2 <= thread_count) 
+    {
+        chunk_count *= 2;
+    }
+
+    std::vector<size_t> bounds(chunk_count + 1);
+    for (size_t i = 0; i <= chunk_count; ++i) 
+    {
+        bounds[i] = size * i / chunk_count;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < chunk_count; ++i) 
+    {
+        workers.emplace_back([&, i]() 
+        {
+            pdq_sort(first + bounds[i], first + bounds[i + 1], comp);
+        });
+    }
+    for (auto& worker : workers) 
+    {
+        worker.join();
+    }
+
+    std::vector<Value> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+    std::vector<Value> merged(size);
+
+    for (size_t width = 1; width < chunk_count; width *= 2) 
+    {
+        workers.clear();
+        for (size_t i = 0; i < chunk_count; i += 2 * width) 
+        {
+            workers.emplace_back([&, i, width]() 
+            {
+                const size_t begin = bounds[i];
+                const size_t middle = bounds[std::min(i + width, chunk_count)];
+                const size_t end = bounds[std::min(i + 2 * width, chunk_count)];
+                std::merge(std::make_move_iterator(buffer.begin() + begin), 
+                           std::make_move_iterator(buffer.begin() + middle),
+                           std::make_move_iterator(buffer.begin() + middle), 
+                           std::make_move_iterator(buffer.begin() + end),
+                           merged.begin() + begin, comp);
+            });
+        }
+        for (auto& worker : workers) 
+        {
+            worker.join();
+        }
+        buffer.swap(merged);
+    }
+
+    std::move(buffer.begin(), buffer.end(), first);
+}
+
+template <typename Iter, typename Compare>
+void hybrid_sort(Iter first, Iter last, Compare comp)
+{
+    const size_t size = static_cast<size_t>(last - first);
+    const size_t thread_count = std::thread::hardware_concurrency();
+
+    if (size >= PARALLEL_SORT_THRESHOLD && thread_count > 1) 
+    {
+        parallel_merge_sort(first, last, comp, thread_count);
+    }
+    else 
+    {
+        pdq_sort(first, last, comp);
+    }
+}
+
+// The direction is checked once here; the sort itself is instantiated per comparator
+template <typename Iter>
+void sort_range(Iter first, Iter last, const bool ascending)
+{
+    if (ascending) 
+    {
+        hybrid_sort(first, last, std::less<>());
+    }
+    else 
+    {
+        hybrid_sort(first, last, std::greater<>());
+    }
+}
+
+// ------------------------------------------------------------
+// Small-Domain Sorts
+// ------------------------------------------------------------
+
+const size_t RADIX_SORT_THRESHOLD = 256;
+
+// One-byte integers and bool: a 256-bucket histogram replaces comparisons entirely
+template <typename T>
+constexpr bool is_byte_sortable_v = std::is_integral_v<T> && sizeof(T) == 1;
+
+// Wider integers and IEEE floats map to unsigned keys that order like the values
+template <typename T>
+constexpr bool is_radix_sortable_v = 
+    (std::is_integral_v<T> && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))
+    || (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+template <typename T>
+using radix_key_t = std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+
+template <typename T>
+void counting_sort_bytes(T* first, T* last, const bool ascending)
+{
+    // Signed bytes are shifted so that negative values come first
+    const unsigned char flip = std::is_signed_v<T> ? 0x80 : 0x00;
+    
+    size_t counts[256] = {};
+    for (T* current = first; current != last; ++current) 
+    {
+        unsigned char byte;
+        std::memcpy(&byte, current, 1);
+        ++counts[byte ^ flip];
+    }
+
+    T* output = first;
+    for (size_t i = 0; i < 256; ++i) 
+    {
+        const size_t bucket = ascending ? i : 255 - i;
+        if (counts[bucket] == 0) continue;
+        
+        const unsigned char byte = static_cast<unsigned char>(bucket ^ flip);
+        T value;
+        std::memcpy(&value, &byte, 1);
+        output = std::fill_n(output, counts[bucket], value);
+    }
+}
+
+// Signed integers: flip the sign bit. Floats: flip all bits of negatives, only the sign bit of positives
+template <typename T>
+radix_key_t<T> to_radix_key(const T value)
+{
+    using Key = radix_key_t<T>;
+    const Key sign_bit = Key(1) << (sizeof(Key) * 8 - 1);
+    
+    Key key;
+    std::memcpy(&key, &value, sizeof(Key));
+    
+    if constexpr (std::is_floating_point_v<T>) 
+    {
+        return (key & sign_bit) ? static_cast<Key>(~key) : static_cast<Key>(key | sign_bit);
+    }
+    else if constexpr (std::is_signed_v<T>) 
+    {
+        return static_cast<Key>(key ^ sign_bit);
+    }
+    else 
+    {
+        return key;
+    }
+}
+
+template <typename T>
+T from_radix_key(radix_key_t<T> key)
+{
+    using Key = radix_key_t<T>;
+    const Key sign_bit = Key(1) << (sizeof(Key) * 8 - 1);
+    
+    if constexpr (std::is_floating_point_v<T>) 
+    {
+        key = (key & sign_bit) ? static_cast<Key>(key ^ sign_bit) : static_cast<Key>(~key);
+    }
+    else if constexpr (std::is_signed_v<T>) 
+    {
+        key = static_cast<Key>(key ^ sign_bit);
+    }
+    
+    T value;
+    std::memcpy(&value, &key, sizeof(Key));
+    return value;
+}
+
+// LSD radix sort, 8 bits per pass; all digit histograms are built in one pass
+// and passes where every key has the same digit are skipped
+template <typename T>
+void radix_sort_values(T* first, T* last, const bool ascending)
+{
+    using Key = radix_key_t<T>;
+    constexpr size_t passes = sizeof(Key);
+    const size_t size = static_cast<size_t>(last - first);
+
+    std::vector<Key> keys(size);
+    std::vector<Key> buffer(size);
+    std::vector<size_t> counts(passes * 256, 0);
+    
+    for (size_t i = 0; i < size; ++i) 
+    {
+        keys[i] = to_radix_key(first[i]);
+        for (size_t pass = 0; pass < passes; ++pass) 
+        {
+            ++counts[pass * 256 + ((keys[i] >> (pass * 8)) & 0xFF)];
+        }
+    }
+
+    for (size_t pass = 0; pass < passes; ++pass) 
+    {
+        size_t* histogram = counts.data() + pass * 256;
+        if (std::find(histogram, histogram + 256, size) != histogram + 256) continue;
+
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit) 
+        {
+            const size_t count = histogram[digit];
+            histogram[digit] = offset;
+            offset += count;
+        }
+        
+        for (size_t i = 0; i < size; ++i) 
+        {
+            buffer[histogram[(keys[i] >> (pass * 8)) & 0xFF]++] = keys[i];
+        }
+        keys.swap(buffer);
+    }
+
+    if (ascending) 
+    {
+        std::transform(keys.begin(), keys.end(), first, from_radix_key<T>);
+    }
+    else 
+    {
+        std::transform(keys.rbegin(), keys.rend(), first, from_radix_key<T>);
+    }
+}
+
+// Picks the algorithm from the element type at compile time
+template <typename T>
+void sort_values(T* first, T* last, const bool ascending)
+{
+    if constexpr (is_byte_sortable_v<T>) 
+    {
+        counting_sort_bytes(first, last, ascending);
+    }
+    else if constexpr (is_radix_sortable_v<T>) 
+    {
+        if (static_cast<size_t>(last - first) >= RADIX_SORT_THRESHOLD) 
+        {
+            radix_sort_values(first, last, ascending);
+        }
+        else 
+        {
+            sort_range(first, last, ascending);
+        }
+    }
+    else 
+    {
+        sort_range(first, last, ascending);
+    }
+}
+
+// ------------------------------------------------------------
+// Score Key Sort
+// ------------------------------------------------------------
+
+const long long MAX_COUNTING_SORT_RANGE = 1 << 16;
+
+// Stable order of students by total score; every score is computed exactly once
+std::vector<size_t> score_sorted_order(const Student* students, const size_t size, const bool ascending)
+{
+    std::vector<size_t> order(size);
+    if (size == 0) return order;
+
+    std::vector<int> keys(size);
+    int min_key = students[0].calculate_total_score();
+    int max_key = min_key;
+    
+    for (size_t i = 0; i < size; ++i) 
+    {
+        keys[i] = students[i].calculate_total_score();
+        min_key = std::min(min_key, keys[i]);
+        max_key = std::max(max_key, keys[i]);
+    }
+
+    const long long range = static_cast<long long>(max_key) - min_key + 1;
+    
+    if (range > MAX_COUNTING_SORT_RANGE) 
+    {
+        for (size_t i = 0; i < size; ++i) 
+        {
+            order[i] = i;
+        }
+        
+        if (ascending) 
+        {
+            std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+        }
+        else 
+        {
+            std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+        }
+        return order;
+    }
+
+    // Counting sort: bucket start positions, then one stable scatter pass
+    std::vector<size_t> positions(static_cast<size_t>(range), 0);
+    for (size_t i = 0; i < size; ++i) 
+    {
+        ++positions[keys[i] - min_key];
+    }
+
+    size_t offset = 0;
+    for (size_t b = 0; b < positions.size(); ++b) 
+    {
+        const size_t bucket = ascending ? b : positions.size() - 1 - b;
+        const size_t count = positions[bucket];
+        positions[bucket] = offset;
+        offset += count;
+    }
+
+    for (size_t i = 0; i < size; ++i) 
+    {
+        order[positions[keys[i] - min_key]++] = i;
+    }
+
+    return order;
+}
+
+// Moves the records into a new table in the given order, reading each one once
+std::vector<Student> gather_students(Student* students, const std::vector<size_t>& order)
+{
+    std::vector<Student> sorted;
+    sorted.reserve(order.size());
+    
+    for (size_t index : order) 
+    {
+        sorted.push_back(std::move(students[index]));
+    }
+    
+    return sorted;
+}
+
+// ------------------------------------------------------------
+// Generic Sort Functions
+// ------------------------------------------------------------
+
+// Template for array of any primitive type
+template <typename T>
+void selection_sort(T* array, const size_t size, const bool ascending = true)
+{
+    sort_values(array, array + size, ascending);
+}
+
+// Overload for array of Students: stable linear-time sort by total score
+void selection_sort(Student* array, const size_t size, const bool ascending = true)
+{
+    std::vector<Student> sorted = gather_students(array, score_sorted_order(array, size, ascending));
+    std::move(sorted.begin(), sorted.end(), array);
+}
+
+// Template for vector of any primitive type
+template <typename T>
+void selection_sort(std::vector<T>& vec, const bool ascending = true)
+{
+    if constexpr (std::is_same_v<T, bool>) 
+    {
+        // std::vector<bool> is packed into bits: counting the true values is enough
+        const size_t true_count = static_cast<size_t>(std::count(vec.begin(), vec.end(), true));
+        const size_t false_count = vec.size() - true_count;
+        std::fill(vec.begin(), vec.end(), ascending);
+        std::fill_n(vec.begin(), ascending ? false_count : true_count, !ascending);
+    }
+    else 
+    {
+        sort_values(vec.data(), vec.data() + vec.size(), ascending);
+    }
+}
+
+// Overload for vector of Students: stable linear-time sort by total score
+void selection_sort(std::vector<Student>& vec, const bool ascending = true)
+{
+    vec = gather_students(vec.data(), score_sorted_order(vec.data(), vec.size(), ascending));
+}
+
+// ------------------------------------------------------------
+// Memory-Mapped Input
+// ------------------------------------------------------------
+
+const size_t MIN_PARSE_CHUNK_SIZE = 1 << 20;
+
+// Read-only view of a whole file; the operating system pages it in on demand
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename)
+    {
+#ifdef _WIN32
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, 
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_, &file_size)) return;
+        size_ = static_cast<size_t>(file_size.QuadPart);
+        open_ = true;
+        if (size_ == 0) return;
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) 
+        {
+            open_ = false;
+            return;
+        }
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        open_ = data_ != nullptr;
+#else
+        descriptor_ = open(filename.c_str(), O_RDONLY);
+        if (descriptor_ < 0) return;
+
+        struct stat file_stat;
+        if (fstat(descriptor_, &file_stat) != 0) return;
+        size_ = static_cast<size_t>(file_stat.st_size);
+        open_ = true;
+        if (size_ == 0) return;
+
+        void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor_, 0);
+        if (address == MAP_FAILED) 
+        {
+            open_ = false;
+            return;
+        }
+        madvise(address, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(address);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+        if (descriptor_ >= 0) close(descriptor_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return data_ != nullptr ? size_ : 0; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int descriptor_ = -1;
+#endif
+};
+
+inline bool is_blank(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Next whitespace-separated token in [position, end); empty at the end of input
+std::string_view next_token(const char*& position, const char* end)
+{
+    while (position < end && is_blank(*position)) ++position;
+    const char* start = position;
+    while (position < end && !is_blank(*position)) ++position;
+    return std::string_view(start, static_cast<size_t>(position - start));
+}
+
+bool parse_int(const std::string_view token, int& value)
+{
+    const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+enum class ParseStatus 
+{
+    Parsed,
+    End,
+    Malformed
+};
+
+// Fields of one record, names point into the parsed text
+struct StudentRecordView 
+{
+    std::string_view lastName;
+    std::string_view firstName;
+    std::string_view patronymic;
+    Date birthDate;
+    int marks[SUBJECT_COUNT];
+};
+
+ParseStatus next_student_record(const char*& position, const char* end, StudentRecordView& record)
+{
+    record.lastName = next_token(position, end);
+    if (record.lastName.empty()) return ParseStatus::End;
+
+    record.firstName = next_token(position, end);
+    record.patronymic = next_token(position, end);
+
+    bool valid = !record.patronymic.empty()
+                 && parse_int(next_token(position, end), record.birthDate.day)
+                 && parse_int(next_token(position, end), record.birthDate.month)
+                 && parse_int(next_token(position, end), record.birthDate.year);
+    
+    for (size_t i = 0; valid && i < SUBJECT_COUNT; ++i) 
+    {
+        valid = parse_int(next_token(position, end), record.marks[i]);
+    }
+    
+    return valid ? ParseStatus::Parsed : ParseStatus::Malformed;
+}
+
+// First line of the file; position moves to the start of the records
+std::string parse_group_line(const char*& position, const char* end)
+{
+    const char* line_end = std::find(position, end, '\n');
+    std::string group_number(position, line_end);
+    if (!group_number.empty() && group_number.back() == '\r') 
+    {
+        group_number.pop_back();
+    }
+    position = line_end == end ? end : line_end + 1;
+    return group_number;
+}
+
+Student make_student(const StudentRecordView& record)
+{
+    Student student;
+    student.lastName.assign(record.lastName);
+    student.firstName.assign(record.firstName);
+    student.patronymic.assign(record.patronymic);
+    student.birthDate = record.birthDate;
+    std::copy(record.marks, record.marks + SUBJECT_COUNT, student.marks);
+    return student;
+}
+
+// Parses records from [begin, end) and stops at the first malformed one, as operator>> did.
+// Returns false if a malformed record was found
+bool parse_student_chunk(const char* begin, const char* end, std::vector<Student>& students)
+{
+    students.reserve(static_cast<size_t>(std::count(begin, end, '\n')) + 1);
+
+    const char* position = begin;
+    StudentRecordView record;
+    ParseStatus status;
+    
+    while ((status = next_student_record(position, end, record)) == ParseStatus::Parsed) 
+    {
+        students.push_back(make_student(record));
+    }
+    
+    return status == ParseStatus::End;
+}
+
+// Calls visit for every record straight from the mapped file; nothing is kept in memory.
+// Returns false if the file could not be opened
+template <typename Visitor>
+bool for_each_student_record(const std::string& filename, std::string& group_number, Visitor&& visit)
+{
+    const MappedFile input_file(filename);
+    
+    if (!input_file.is_open()) 
+    {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return false;
+    }
+
+    const char* position = input_file.data();
+    const char* end = position + input_file.size();
+
+    group_number = parse_group_line(position, end);
+
+    StudentRecordView record;
+    while (next_student_record(position, end, record) == ParseStatus::Parsed) 
+    {
+        visit(record);
+    }
+    
+    return true;
+}
+
+// ------------------------------------------------------------
+// Buffered Output
+// ------------------------------------------------------------
+
+const size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+const size_t FORMAT_BATCH_SIZE = 8192;
+
+void append_int(std::string& buffer, const int value)
+{
+    char digits[16];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+void append_student(std::string& buffer, const Student& student)
+{
+    buffer.append(student.lastName).append(" ")
+          .append(student.firstName).append(" ")
+          .append(student.patronymic).append("\nBirth date: ");
+    append_int(buffer, student.birthDate.day);
+    buffer.append(".");
+    append_int(buffer, student.birthDate.month);
+    buffer.append(".");
+    append_int(buffer, student.birthDate.year);
+    buffer.append("\nMarks: ");
+    
+    for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+    {
+        append_int(buffer, student.marks[i]);
+        buffer.append(i < SUBJECT_COUNT - 1 ? " " : "\n");
+    }
+    
+    buffer.append("Total score: ");
+    append_int(buffer, student.calculate_total_score());
+    buffer.append("\n----------------------------------------\n");
+}
+
+// Formats students in batches on workers that are started once: worker w fills batches w, w + T, ...
+// into a private buffer and hands it over through its slot, while the calling thread writes
+// the slots in batch order, one write call each. The header goes in front of the first batch
+void write_students(std::ofstream& output_file, const std::string& header, const std::vector<Student>& students)
+{
+    const size_t batch_count = std::max<size_t>(1, (students.size() + FORMAT_BATCH_SIZE - 1) / FORMAT_BATCH_SIZE);
+    const size_t thread_count = std::min(std::max<size_t>(1, std::thread::hardware_concurrency()), batch_count);
+
+    auto format_batch = [&header, &students](std::string& buffer, const size_t batch) 
+    {
+        buffer.clear();
+        if (batch == 0) 
+        {
+            buffer.append(header);
+        }
+        
+        const size_t end = std::min(students.size(), (batch + 1) * FORMAT_BATCH_SIZE);
+        for (size_t i = batch * FORMAT_BATCH_SIZE; i < end; ++i) 
+        {
+            append_student(buffer, students[i]);
+        }
+    };
+
+    auto write_buffer = [&output_file](const std::string& buffer) 
+    {
+        output_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    };
+
+    if (thread_count == 1) 
+    {
+        std::string buffer;
+        buffer.reserve(OUTPUT_BUFFER_SIZE);
+        for (size_t batch = 0; batch < batch_count; ++batch) 
+        {
+            format_batch(buffer, batch);
+            write_buffer(buffer);
+        }
+        return;
+    }
+
+    // A full slot belongs to the writer until it marks it empty again
+    struct Slot 
+    {
+        std::string buffer;
+        bool full = false;
+    };
+    
+    std::vector<Slot> slots(thread_count);
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < thread_count; ++w) 
+    {
+        slots[w].buffer.reserve(OUTPUT_BUFFER_SIZE);
+        workers.emplace_back([&, w]() 
+        {
+            std::string buffer;
+            buffer.reserve(OUTPUT_BUFFER_SIZE);
+            
+            for (size_t batch = w; batch < batch_count; batch += thread_count) 
+            {
+                format_batch(buffer, batch);
+                
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return !slots[w].full; });
+                slots[w].buffer.swap(buffer);
+                slots[w].full = true;
+                changed.notify_all();
+            }
+        });
+    }
+
+    for (size_t batch = 0; batch < batch_count; ++batch) 
+    {
+        Slot& slot = slots[batch % thread_count];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&slot]() { return slot.full; });
+        }
+        
+        write_buffer(slot.buffer);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.full = false;
+        }
+        changed.notify_all();
+    }
+
+    for (auto& worker : workers) 
+    {
+        worker.join();
+    }
+}
+
+// ------------------------------------------------------------
+// Input/Output Functions
+// ------------------------------------------------------------
+
+// Records are expected one per line: the file is split at line boundaries
+// and the chunks are parsed in parallel straight from the mapped pages
+std::pair<std::string, std::vector<Student>> read_from_file(const std::string& filename)
+{
+    const MappedFile input_file(filename);
+    std::string group_number;
+    std::vector<Student> students;
+    
+    if (!input_file.is_open()) 
+    {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return std::make_pair(group_number, students);
+    }
+
+    const char* begin = input_file.data();
+    const char* end = begin + input_file.size();
+
+    group_number = parse_group_line(begin, end);
+
+    const size_t data_size = static_cast<size_t>(end - begin);
+    const size_t hardware_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t chunk_count = std::max<size_t>(1, std::min(hardware_threads, data_size / MIN_PARSE_CHUNK_SIZE));
+
+    std::vector<const char*> bounds(chunk_count + 1, end);
+    bounds[0] = begin;
+    for (size_t i = 1; i < chunk_count; ++i) 
+    {
+        const char* split = std::max(bounds[i - 1], begin + data_size * i / chunk_count);
+        const char* newline = std::find(split, end, '\n');
+        bounds[i] = newline == end ? end : newline + 1;
+    }
+
+    std::vector<std::vector<Student>> parsed(chunk_count);
+    std::vector<char> complete(chunk_count, 1);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunk_count; ++i) 
+    {
+        workers.emplace_back([&, i]() 
+        {
+            complete[i] = parse_student_chunk(bounds[i], bounds[i + 1], parsed[i]);
+        });
+    }
+    complete[0] = parse_student_chunk(bounds[0], bounds[1], parsed[0]);
+    for (auto& worker : workers) 
+    {
+        worker.join();
+    }
+
+    // Everything after the first malformed record is dropped
+    size_t total = 0;
+    size_t used_chunks = 0;
+    while (used_chunks < chunk_count) 
+    {
+        total += parsed[used_chunks].size();
+        if (!complete[used_chunks++]) break;
+    }
+
+    students.reserve(total);
+    for (size_t i = 0; i < used_chunks; ++i) 
+    {
+        std::move(parsed[i].begin(), parsed[i].end(), std::back_inserter(students));
+    }
+
+    return std::make_pair(group_number, std::move(students));
+}
+
+void write_to_file(const std::string& filename, 
+                   const std::string& group_number, 
+                   const std::vector<Student>& students)
+{
+    // Everything, the header included, is formatted into large buffers by write_students,
+    // so the stream itself writes straight through
+    std::ofstream output_file;
+    output_file.rdbuf()->pubsetbuf(nullptr, 0);
+    output_file.open(filename);
+    
+    if (!output_file.is_open()) 
+    {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return;
+    }
+
+    const std::string header = "Group: " + group_number + "\n\n"
+                               "Students sorted by total score (ascending):\n"
+                               "============================================\n\n";
+    
+    write_students(output_file, header, students);
+
+    output_file.close();
+}
+
+// ------------------------------------------------------------
+// Columnar Student Table
+// ------------------------------------------------------------
+
+// Every distinct name is stored once, null-terminated, in a single byte arena.
+// Offsets are 32-bit, so the arena is limited to UINT32_MAX bytes
+class NameArena
+{
+public:
+    // Throws std::length_error if a new name would not fit the 32-bit offsets
+    uint32_t intern(const std::string_view name)
+    {
+        if ((count_ + 1) * 2 > slots_.size()) 
+        {
+            grow();
+        }
+
+        const size_t mask = slots_.size() - 1;
+        for (size_t slot = std::hash<std::string_view>()(name) & mask; ; slot = (slot + 1) & mask) 
+        {
+            if (slots_[slot] == 0) 
+            {
+                if (name.size() + 1 > UINT32_MAX - bytes_.size()) 
+                {
+                    throw std::length_error("NameArena: names exceed 4 GiB of 32-bit offsets");
+                }
+                
+                const uint32_t offset = static_cast<uint32_t>(bytes_.size());
+                bytes_.append(name).push_back('\0');
+                slots_[slot] = offset + 1;
+                ++count_;
+                return offset;
+            }
+            
+            if (get(slots_[slot] - 1) == name) 
+            {
+                return slots_[slot] - 1;
+            }
+        }
+    }
+
+    std::string_view get(const uint32_t offset) const
+    {
+        return std::string_view(bytes_.data() + offset);
+    }
+
+    size_t count() const { return count_; }
+    size_t byte_size() const { return bytes_.size(); }
+
+private:
+    std::string bytes_;
+    std::vector<uint32_t> slots_;   // open addressing, offset + 1, 0 marks an empty slot
+    size_t count_ = 0;
+
+    void grow()
+    {
+        std::vector<uint32_t> old_slots(std::max<size_t>(16, slots_.size() * 2), 0);
+        old_slots.swap(slots_);
+        
+        const size_t mask = slots_.size() - 1;
+        for (const uint32_t value : old_slots) 
+        {
+            if (value == 0) continue;
+            
+            size_t slot = std::hash<std::string_view>()(get(value - 1)) & mask;
+            while (slots_[slot] != 0) 
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = value;
+        }
+    }
+};
+
+// year:23 | month:4 | day:5, so comparing keys compares dates
+uint32_t pack_date(const Date& date)
+{
+    return (static_cast<uint32_t>(date.year) << 9) 
+         | (static_cast<uint32_t>(date.month) << 5) 
+         | static_cast<uint32_t>(date.day);
+}
+
+Date unpack_date(const uint32_t key)
+{
+    return Date{static_cast<int>(key & 31), static_cast<int>((key >> 5) & 15), static_cast<int>(key >> 9)};
+}
+
+// Students stored column by column: a scan over scores touches only the marks column
+class StudentTable
+{
+public:
+    void reserve(const size_t count)
+    {
+        last_names_.reserve(count);
+        first_names_.reserve(count);
+        patronymics_.reserve(count);
+        birth_keys_.reserve(count);
+        marks_.reserve(count * SUBJECT_COUNT);
+    }
+
+    // Rejects records that do not fit the packed columns: marks outside 0..255, impossible dates
+    bool add(const std::string_view last_name, const std::string_view first_name, 
+             const std::string_view patronymic, const Date& birth_date, const int* marks)
+    {
+        if (birth_date.day < 1 || birth_date.day > 31 || birth_date.month < 1 || birth_date.month > 12 
+            || birth_date.year < 0 || birth_date.year >= (1 << 23)) 
+        {
+            return false;
+        }
+        
+        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        {
+            if (marks[i] < 0 || marks[i] > 255) return false;
+        }
+
+        last_names_.push_back(names_.intern(last_name));
+        first_names_.push_back(names_.intern(first_name));
+        patronymics_.push_back(names_.intern(patronymic));
+        birth_keys_.push_back(pack_date(birth_date));
+        
+        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        {
+            marks_.push_back(static_cast<uint8_t>(marks[i]));
+        }
+        
+        return true;
+    }
+
+    bool add(const Student& student)
+    {
+        return add(student.lastName, student.firstName, student.patronymic, student.birthDate, student.marks);
+    }
+
+    size_t size() const { return birth_keys_.size(); }
+
+    std::string_view last_name(const size_t index) const { return names_.get(last_names_[index]); }
+    std::string_view first_name(const size_t index) const { return names_.get(first_names_[index]); }
+    std::string_view patronymic(const size_t index) const { return names_.get(patronymics_[index]); }
+    Date birth_date(const size_t index) const { return unpack_date(birth_keys_[index]); }
+    const uint8_t* marks(const size_t index) const { return marks_.data() + index * SUBJECT_COUNT; }
+
+    int total_score(const size_t index) const
+    {
+        const uint8_t* row = marks(index);
+        int total = 0;
+        
+        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        {
+            total += row[i];
+        }
+        
+        return total;
+    }
+
+    // Rebuilds a full record, e.g. for the existing output functions
+    Student get(const size_t index) const
+    {
+        Student student;
+        student.lastName.assign(last_name(index));
+        student.firstName.assign(first_name(index));
+        student.patronymic.assign(patronymic(index));
+        student.birthDate = birth_date(index);
+        
+        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        {
+            student.marks[i] = marks(index)[i];
+        }
+        
+        return student;
+    }
+
+    double average_total_score() const
+    {
+        if (size() == 0) return 0.0;
+        
+        uint64_t sum = 0;
+        for (const uint8_t mark : marks_) 
+        {
+            sum += mark;
+        }
+        
+        return static_cast<double>(sum) / static_cast<double>(size());
+    }
+
+    const std::vector<uint8_t>& marks_column() const { return marks_; }
+    const std::vector<uint32_t>& birth_key_column() const { return birth_keys_; }
+    const NameArena& names() const { return names_; }
+
+private:
+    NameArena names_;
+    std::vector<uint32_t> last_names_;
+    std::vector<uint32_t> first_names_;
+    std::vector<uint32_t> patronymics_;
+    std::vector<uint32_t> birth_keys_;
+    std::vector<uint8_t> marks_;    // SUBJECT_COUNT marks per student
+};
+
+// Same format and stopping rule as read_from_file, records go straight into the columns
+std::pair<std::string, StudentTable> read_table_from_file(const std::string& filename)
+{
+    std::string group_number;
+    StudentTable table;
+    
+    for_each_student_record(filename, group_number, [&table](const StudentRecordView& record) 
+    {
+        if (!table.add(record.lastName, record.firstName, record.patronymic, record.birthDate, record.marks)) 
+        {
+            std::cerr << "Warning: skipped a record that does not fit the table: " << record.lastName << std::endl;
+        }
+    });
+
+    return std::make_pair(group_number, std::move(table));
+}
+
+// ------------------------------------------------------------
+// Streaming Score Queries
+// ------------------------------------------------------------
+
+int total_score(const StudentRecordView& record)
+{
+    int total = 0;
+    
+    for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+    {
+        total += record.marks[i];
+    }
+    
+    return total;
+}
+
+// k best (or worst) students in one pass with a bounded heap: O(k) memory, O(n log k) time.
+// Among equal scores the earlier record wins; the result is ordered from best to worst (or worst to best)
+std::vector<Student> stream_top_k(const std::string& filename, const size_t k, const bool best = true)
+{
+    struct Candidate 
+    {
+        int score;
+        size_t sequence;
+        Student student;
+    };
+
+    // The heap top is the candidate that would be dropped first
+    auto worse = [best](const Candidate& a, const Candidate& b) 
+    {
+        if (a.score != b.score) return best ? a.score > b.score : a.score < b.score;
+        return a.sequence < b.sequence;
+    };
+
+    std::vector<Candidate> heap;
+    heap.reserve(k);
+    size_t sequence = 0;
+    std::string group_number;
+
+    for_each_student_record(filename, group_number, [&](const StudentRecordView& record) 
+    {
+        const int score = total_score(record);
+        const size_t current = sequence++;
+        if (k == 0) return;
+
+        if (heap.size() < k) 
+        {
+            heap.push_back(Candidate{score, current, make_student(record)});
+            std::push_heap(heap.begin(), heap.end(), worse);
+            return;
+        }
+
+        const Candidate& weakest = heap.front();
+        const bool better = best ? score > weakest.score : score < weakest.score;
+        if (!better) return;
+
+        std::pop_heap(heap.begin(), heap.end(), worse);
+        heap.back() = Candidate{score, current, make_student(record)};
+        std::push_heap(heap.begin(), heap.end(), worse);
+    });
+
+    std::sort_heap(heap.begin(), heap.end(), worse);
+
+    std::vector<Student> result;
+    result.reserve(heap.size());
+    for (auto& candidate : heap) 
+    {
+        result.push_back(std::move(candidate.student));
+    }
+    
+    return result;
+}
+
+// In-memory variant: nth_element over precomputed scores, then only the k selected are sorted
+std::vector<Student> select_top_k(const std::vector<Student>& students, size_t k, const bool best = true)
+{
+    k = std::min(k, students.size());
+    
+    std::vector<int> scores(students.size());
+    std::vector<size_t> order(students.size());
+    for (size_t i = 0; i < students.size(); ++i) 
+    {
+        scores[i] = students[i].calculate_total_score();
+        order[i] = i;
+    }
+
+    auto before = [&scores, best](const size_t a, const size_t b) 
+    {
+        if (scores[a] != scores[b]) return best ? scores[a] > scores[b] : scores[a] < scores[b];
+        return a < b;
+    };
+
+    if (k < order.size()) 
+    {
+        std::nth_element(order.begin(), order.begin() + k, order.end(), before);
+    }
+    std::sort(order.begin(), order.begin() + k, before);
+
+    std::vector<Student> result;
+    result.reserve(k);
+    for (size_t i = 0; i < k; ++i) 
+    {
+        result.push_back(students[order[i]]);
+    }
+    
+    return result;
+}
+
+// Counts per total score; memory depends only on the score range, not on the number of students
+class ScoreHistogram
+{
+public:
+    void add(const int score)
+    {
+        if (counts_.empty()) 
+        {
+            min_score_ = score;
+        }
+        
+        if (score < min_score_) 
+        {
+            counts_.insert(counts_.begin(), static_cast<size_t>(min_score_ - score), 0);
+            min_score_ = score;
+        }
+        
+        const size_t bucket = static_cast<size_t>(score - min_score_);
+        if (bucket >= counts_.size()) 
+        {
+            counts_.resize(bucket + 1, 0);
+        }
+        
+        ++counts_[bucket];
+        ++total_;
+    }
+
+    uint64_t size() const { return total_; }
+
+    // Students with a strictly lower score
+    uint64_t count_below(const int score) const
+    {
+        uint64_t below = 0;
+        for (size_t bucket = 0; bucket < counts_.size() && min_score_ + static_cast<int>(bucket) < score; ++bucket) 
+        {
+            below += counts_[bucket];
+        }
+        return below;
+    }
+
+    uint64_t count_equal(const int score) const
+    {
+        if (score < min_score_ || score - min_score_ >= static_cast<int>(counts_.size())) return 0;
+        return counts_[static_cast<size_t>(score - min_score_)];
+    }
+
+    // Place in the ranking from the best, equal scores share a place (1 is the best)
+    uint64_t rank(const int score) const
+    {
+        return total_ - count_below(score) - count_equal(score) + 1;
+    }
+
+    // Share of students with a lower score, in percent
+    double percentile(const int score) const
+    {
+        return total_ == 0 ? 0.0 : 100.0 * static_cast<double>(count_below(score)) / static_cast<double>(total_);
+    }
+
+    // Lowest score such that at least percent% of students have this score or lower
+    int score_at_percentile(const double percent) const
+    {
+        const double needed = percent / 100.0 * static_cast<double>(total_);
+        uint64_t seen = 0;
+        
+        for (size_t bucket = 0; bucket < counts_.size(); ++bucket) 
+        {
+            seen += counts_[bucket];
+            if (seen > 0 && static_cast<double>(seen) >= needed) 
+            {
+                return min_score_ + static_cast<int>(bucket);
+            }
+        }
+        
+        return min_score_ + static_cast<int>(counts_.size()) - 1;
+    }
+
+private:
+    std::vector<uint64_t> counts_;
+    int min_score_ = 0;
+    uint64_t total_ = 0;
+};
+
+ScoreHistogram stream_score_histogram(const std::string& filename)
+{
+    ScoreHistogram histogram;
+    std::string group_number;
+    
+    for_each_student_record(filename, group_number, [&histogram](const StudentRecordView& record) 
+    {
+        histogram.add(total_score(record));
+    });
+    
+    return histogram;
+}
+
+// ------------------------------------------------------------
+// External Merge Sort
+// ------------------------------------------------------------
+
+const size_t EXTERNAL_RUN_RECORDS = 1 << 20;
+const size_t RUN_IO_BUFFER_SIZE = 1 << 20;
+const uintmax_t IN_MEMORY_SORT_LIMIT = uintmax_t(256) << 20;    // larger input files are sorted externally
+
+// Binary run record: three names with 16-bit lengths, then birth date and marks as 32-bit integers.
+// Returns false (and appends nothing) if a name does not fit the 16-bit length
+bool append_run_record(std::string& buffer, const Student& student)
+{
+    for (const std::string* name : {&student.lastName, &student.firstName, &student.patronymic}) 
+    {
+        if (name->size() > UINT16_MAX) 
+        {
+            std::cerr << "Error: Name longer than " << UINT16_MAX << " bytes in record of " 
+                      << student.lastName.substr(0, 32) << std::endl;
+            return false;
+        }
+    }
+
+    for (const std::string* name : {&student.lastName, &student.firstName, &student.patronymic}) 
+    {
+        const uint16_t length = static_cast<uint16_t>(name->size());
+        buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        buffer.append(name->data(), length);
+    }
+
+    const int32_t fields[3 + SUBJECT_COUNT] = {
+        student.birthDate.day, student.birthDate.month, student.birthDate.year,
+        student.marks[0], student.marks[1], student.marks[2], student.marks[3], student.marks[4]
+    };
+    buffer.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+    return true;
+}
+
+// Sorts one run stably by total score and spills it to a temporary file
+bool spill_run(const std::filesystem::path& path, std::vector<Student>& run, const bool ascending)
+{
+    std::ofstream run_file(path, std::ios::binary);
+    if (!run_file.is_open()) 
+    {
+        std::cerr << "Error: Unable to create temporary file " << path.string() << std::endl;
+        return false;
+    }
+
+    std::string buffer;
+    buffer.reserve(RUN_IO_BUFFER_SIZE + 1024);
+    
+    for (const size_t index : score_sorted_order(run.data(), run.size(), ascending)) 
+    {
+        if (!append_run_record(buffer, run[index])) return false;
+        if (buffer.size() >= RUN_IO_BUFFER_SIZE) 
+        {
+            run_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    run_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    
+    return static_cast<bool>(run_file);
+}
+
+class RunReader
 {
-    return calculate_total_score() > other.calculate_total_score();
-}
+public:
+    explicit RunReader(const std::filesystem::path& path) : buffer_(RUN_IO_BUFFER_SIZE)
+    {
+        file_.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        file_.open(path, std::ios::binary);
+        advance();
+    }
 
-// ------------------------------------------------------------
-// Generic Selection Sort Functions
-// ------------------------------------------------------------
+    bool exhausted() const { return exhausted_; }
+    const Student& current() const { return current_; }
+    int score() const { return score_; }
 
-// Template for array of any primitive type
-template <typename T>
-void selection_sort(T* array, const size_t size, const bool ascending = true)
-{
-    if (size == 0) return;
-    
-    for (size_t i = 0; i < size - 1; ++i) 
+    void advance()
     {
-        size_t extreme_index = i;
-        
-        for (size_t j = i + 1; j < size; ++j) 
+        for (std::string* name : {&current_.lastName, &current_.firstName, &current_.patronymic}) 
         {
-            if (ascending) 
-            {
-                if (array[j] < array[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
-            }
-            else 
+            uint16_t length = 0;
+            if (!file_.read(reinterpret_cast<char*>(&length), sizeof(length))) 
             {
-                if (array[j] > array[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
+                exhausted_ = true;
+                return;
             }
+            name->resize(length);
+            file_.read(name->data(), length);
         }
-        
-        if (extreme_index != i) 
+
+        int32_t fields[3 + SUBJECT_COUNT];
+        if (!file_.read(reinterpret_cast<char*>(fields), sizeof(fields))) 
         {
-            T temp = array[i];
-            array[i] = array[extreme_index];
-            array[extreme_index] = temp;
+            exhausted_ = true;
+            return;
         }
+        
+        current_.birthDate = Date{fields[0], fields[1], fields[2]};
+        std::copy(fields + 3, fields + 3 + SUBJECT_COUNT, current_.marks);
+        score_ = current_.calculate_total_score();
     }
-}
 
-// Overload for array of Students
-void selection_sort(Student* array, const size_t size, const bool ascending = true)
+private:
+    std::vector<char> buffer_;
+    std::ifstream file_;
+    Student current_;
+    int score_ = 0;
+    bool exhausted_ = false;
+};
+
+// Tournament tree of losers over k sources: every internal node keeps the source that lost there,
+// so replacing the winner costs one comparison per level on the path to the root
+template <typename Less>
+class LoserTree
 {
-    if (size == 0) return;
-    
-    for (size_t i = 0; i < size - 1; ++i) 
+public:
+    LoserTree(const size_t count, Less less) : count_(count), losers_(count), less_(less)
     {
-        size_t extreme_index = i;
+        std::vector<size_t> winners(2 * count);
+        for (size_t i = 0; i < count; ++i) 
+        {
+            winners[count + i] = i;
+        }
         
-        for (size_t j = i + 1; j < size; ++j) 
+        for (size_t node = count - 1; node >= 1; --node) 
         {
-            if (ascending) 
+            const size_t left = winners[2 * node];
+            const size_t right = winners[2 * node + 1];
+            
+            if (less_(right, left)) 
             {
-                if (array[j] < array[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
+                winners[node] = right;
+                losers_[node] = left;
             }
             else 
             {
-                if (array[j] > array[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
+                winners[node] = left;
+                losers_[node] = right;
             }
         }
         
-        if (extreme_index != i) 
-        {
-            Student temp = array[i];
-            array[i] = array[extreme_index];
-            array[extreme_index] = temp;
-        }
+        winner_ = count > 1 ? winners[1] : 0;
     }
-}
 
-// Template for vector of any primitive type
-template <typename T>
-void selection_sort(std::vector<T>& vec, const bool ascending = true)
-{
-    if (vec.empty()) return;
-    
-    const size_t size = vec.size();
-    
-    for (size_t i = 0; i < size - 1; ++i) 
+    size_t winner() const { return winner_; }
+
+    // Call after the winning source has moved to its next element
+    void replay()
     {
-        size_t extreme_index = i;
-        
-        for (size_t j = i + 1; j < size; ++j) 
+        size_t current = winner_;
+        for (size_t node = (winner_ + count_) / 2; node >= 1; node /= 2) 
         {
-            if (ascending) 
-            {
-                if (vec[j] < vec[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
-            }
-            else 
+            if (less_(losers_[node], current)) 
             {
-                if (vec[j] > vec[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
+                std::swap(losers_[node], current);
             }
         }
-        
-        if (extreme_index != i) 
+        winner_ = current;
+    }
+
+private:
+    size_t count_;
+    std::vector<size_t> losers_;
+    size_t winner_ = 0;
+    Less less_;
+};
+
+// Removes the temporary run files however the sort ends
+struct RunFiles 
+{
+    std::vector<std::filesystem::path> paths;
+
+    ~RunFiles()
+    {
+        std::error_code error;
+        for (const auto& path : paths) 
         {
-            T temp = vec[i];
-            vec[i] = vec[extreme_index];
-            vec[extreme_index] = temp;
+            std::filesystem::remove(path, error);
         }
     }
-}
+};
 
-// Overload for vector of Students
-void selection_sort(std::vector<Student>& vec, const bool ascending = true)
+// Sorts a student file of any size by total score using memory for about two runs:
+// runs are sorted and spilled in the background while the next run is parsed,
+// then merged with a loser tree straight into the formatted report.
+// Equal scores keep their input order, exactly like the in-memory sort
+bool external_sort_file(const std::string& input_filename, 
+                        const std::string& output_filename,
+                        const size_t run_records = EXTERNAL_RUN_RECORDS,
+                        const bool ascending = true)
 {
-    if (vec.empty()) return;
+    RunFiles run_files;
+    std::vector<Student> run;
+    run.reserve(std::min(run_records, EXTERNAL_RUN_RECORDS));
+    std::future<bool> pending;
+    bool spilled = true;
+
+    const std::filesystem::path temp_directory = std::filesystem::temp_directory_path();
+    const std::string prefix = "students_run_" 
+                             + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_"
+                             + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "_";
+
+    auto start_spill = [&]() 
+    {
+        if (pending.valid()) 
+        {
+            spilled = pending.get() && spilled;
+        }
+        
+        run_files.paths.push_back(temp_directory / (prefix + std::to_string(run_files.paths.size()) + ".bin"));
+        pending = std::async(std::launch::async, 
+            [path = run_files.paths.back(), sorted_run = std::move(run), ascending]() mutable 
+            {
+                return spill_run(path, sorted_run, ascending);
+            });
+        
+        run = std::vector<Student>();
+        run.reserve(std::min(run_records, EXTERNAL_RUN_RECORDS));
+    };
+
+    std::string group_number;
+    const bool opened = for_each_student_record(input_filename, group_number, [&](const StudentRecordView& record) 
+    {
+        run.push_back(make_student(record));
+        if (run.size() >= std::max<size_t>(1, run_records)) 
+        {
+            start_spill();
+        }
+    });
+    
+    if (!opened) return false;
+
+    // Nothing was spilled: the whole input is one run and is sorted in memory
+    if (run_files.paths.empty()) 
+    {
+        selection_sort(run, ascending);
+    }
+    else if (!run.empty()) 
+    {
+        start_spill();
+    }
+    
+    if (pending.valid()) 
+    {
+        spilled = pending.get() && spilled;
+    }
     
-    const size_t size = vec.size();
+    if (!spilled) return false;
+
+    std::ofstream output_file;
+    output_file.rdbuf()->pubsetbuf(nullptr, 0);
+    output_file.open(output_filename);
     
-    for (size_t i = 0; i < size - 1; ++i) 
+    if (!output_file.is_open()) 
     {
-        size_t extreme_index = i;
-        
-        for (size_t j = i + 1; j < size; ++j) 
+        std::cerr << "Error: Unable to open file " << output_filename << std::endl;
+        return false;
+    }
+
+    std::string buffer;
+    buffer.reserve(OUTPUT_BUFFER_SIZE + 1024);
+    buffer.append("Group: ").append(group_number).append("\n\n");
+    buffer.append(ascending ? "Students sorted by total score (ascending):\n" 
+                            : "Students sorted by total score (descending):\n");
+    buffer.append("============================================\n\n");
+
+    auto emit = [&](const Student& student) 
+    {
+        append_student(buffer, student);
+        if (buffer.size() >= OUTPUT_BUFFER_SIZE) 
         {
-            if (ascending) 
-            {
-                if (vec[j] < vec[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
-            }
-            else 
+            output_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    };
+
+    if (run_files.paths.empty()) 
+    {
+        for (const auto& student : run) 
+        {
+            emit(student);
+        }
+    }
+    else 
+    {
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const auto& path : run_files.paths) 
+        {
+            readers.push_back(std::make_unique<RunReader>(path));
+        }
+
+        // Exhausted runs lose to everything; equal scores go to the earlier run
+        auto less = [&readers, ascending](const size_t a, const size_t b) 
+        {
+            if (readers[a]->exhausted()) return false;
+            if (readers[b]->exhausted()) return true;
+            if (readers[a]->score() != readers[b]->score()) 
             {
-                if (vec[j] > vec[extreme_index]) 
-                {
-                    extreme_index = j;
-                }
+                return ascending ? readers[a]->score() < readers[b]->score() 
+                                 : readers[a]->score() > readers[b]->score();
             }
-        }
-        
-        if (extreme_index != i) 
+            return a < b;
+        };
+
+        LoserTree<decltype(less)> tree(readers.size(), less);
+        while (!readers[tree.winner()]->exhausted()) 
         {
-            Student temp = vec[i];
-            vec[i] = vec[extreme_index];
-            vec[extreme_index] = temp;
+            emit(readers[tree.winner()]->current());
+            readers[tree.winner()]->advance();
+            tree.replay();
         }
     }
+
+    output_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(output_file);
 }
 
 // ------------------------------------------------------------
-// Input/Output Functions
+// Live Ranking Index
 // ------------------------------------------------------------
 
-std::pair<std::string, std::vector<Student>> read_from_file(const std::string& filename)
+const int MAX_MARK = 255;
+
+// Students bucketed by total score with a Fenwick tree of bucket sizes on top:
+// insert, remove, mark updates, rank and k-th lookups are O(log S) for S possible scores.
+// Rank 1 is the best score; students with equal scores share a rank
+class ScoreRankIndex
 {
-    std::ifstream input_file(filename);
-    std::string group_number;
-    std::vector<Student> students;
-    
-    if (!input_file.is_open()) 
+public:
+    using StudentId = uint32_t;
+    static constexpr StudentId INVALID_ID = UINT32_MAX;
+
+    explicit ScoreRankIndex(const int max_total_score = static_cast<int>(SUBJECT_COUNT) * MAX_MARK)
+        : max_score_(max_total_score), 
+          tree_(static_cast<size_t>(max_total_score) + 2, 0), 
+          buckets_(static_cast<size_t>(max_total_score) + 1)
     {
-        std::cerr << "Error: Unable to open file " << filename << std::endl;
-        return std::make_pair(group_number, students);
     }
 
-    std::getline(input_file, group_number);
+    // Returns INVALID_ID if the total score is outside 0..max_total_score
+    StudentId insert(const Student& student)
+    {
+        const int score = student.calculate_total_score();
+        if (!valid_score(score)) return INVALID_ID;
 
-    Student current_student;
-    
-    while (input_file >> current_student.lastName 
-                      >> current_student.firstName 
-                      >> current_student.patronymic
-                      >> current_student.birthDate.day 
-                      >> current_student.birthDate.month 
-                      >> current_student.birthDate.year) 
+        StudentId id;
+        if (!free_ids_.empty()) 
+        {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+            entries_[id].student = student;
+        }
+        else 
+        {
+            id = static_cast<StudentId>(entries_.size());
+            entries_.push_back(Entry{student, 0, 0, false});
+        }
+        
+        link(id, score);
+        ++size_;
+        return id;
+    }
+
+    bool remove(const StudentId id)
     {
-        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        if (!contains(id)) return false;
+
+        unlink(id);
+        entries_[id].student = Student();
+        free_ids_.push_back(id);
+        --size_;
+        return true;
+    }
+
+    // Moves the student to the bucket of the new total; the record keeps its id
+    bool update_marks(const StudentId id, const int* marks)
+    {
+        if (!contains(id)) return false;
+
+        Student& student = entries_[id].student;
+        int old_marks[SUBJECT_COUNT];
+        std::copy(student.marks, student.marks + SUBJECT_COUNT, old_marks);
+        std::copy(marks, marks + SUBJECT_COUNT, student.marks);
+
+        const int score = student.calculate_total_score();
+        if (!valid_score(score)) 
+        {
+            std::copy(old_marks, old_marks + SUBJECT_COUNT, student.marks);
+            return false;
+        }
+        
+        if (score != entries_[id].score) 
         {
-            input_file >> current_student.marks[i];
+            unlink(id);
+            link(id, score);
         }
         
-        students.push_back(current_student);
+        return true;
     }
 
-    input_file.close();
-    return std::make_pair(group_number, students);
-}
+    bool contains(const StudentId id) const
+    {
+        return id < entries_.size() && entries_[id].alive;
+    }
 
-void write_to_file(const std::string& filename, 
-                   const std::string& group_number, 
-                   const std::vector<Student>& students)
-{
-    std::ofstream output_file(filename);
-    
-    if (!output_file.is_open()) 
+    // 0 for an unknown id
+    size_t rank(const StudentId id) const
     {
-        std::cerr << "Error: Unable to open file " << filename << std::endl;
-        return;
+        if (!contains(id)) return 0;
+        return count_better(entries_[id].score) + 1;
     }
 
-    output_file << "Group: " << group_number << "\n\n";
-    output_file << "Students sorted by total score (ascending):\n";
-    output_file << "============================================\n\n";
-    
-    for (const auto& student : students) 
+    // k-th student from the best, k starts at 1; INVALID_ID if k is out of range
+    StudentId kth(const size_t k) const
     {
-        output_file << student.lastName << " " 
-                    << student.firstName << " " 
-                    << student.patronymic << "\n";
-        output_file << "Birth date: " 
-                    << student.birthDate.day << "." 
-                    << student.birthDate.month << "." 
-                    << student.birthDate.year << "\n";
-        output_file << "Marks: ";
-        
-        for (size_t i = 0; i < SUBJECT_COUNT; ++i) 
+        if (k == 0 || k > size_) return INVALID_ID;
+
+        // Descend the Fenwick tree to the first position whose prefix count reaches k
+        size_t position = 0;
+        size_t remaining = k;
+        size_t step = 1;
+        while (step * 2 < tree_.size()) 
         {
-            output_file << student.marks[i];
-            (i < SUBJECT_COUNT - 1) ? output_file << " " : output_file << "\n";
+            step *= 2;
         }
         
-        output_file << "Total score: " << student.calculate_total_score() << "\n";
-        output_file << "----------------------------------------\n";
+        for (; step > 0; step /= 2) 
+        {
+            if (position + step < tree_.size() && tree_[position + step] < remaining) 
+            {
+                position += step;
+                remaining -= tree_[position];
+            }
+        }
+
+        // position is the number of better buckets skipped, the bucket itself is the next one
+        const int score = max_score_ - static_cast<int>(position);
+        return buckets_[static_cast<size_t>(score)][remaining - 1];
     }
 
-    output_file.close();
-}
+    // Only for ids that are currently in the index (see contains)
+    const Student& student(const StudentId id) const 
+    { 
+        assert(contains(id));
+        return entries_[id].student; 
+    }
+    
+    int score(const StudentId id) const 
+    { 
+        assert(contains(id));
+        return entries_[id].score; 
+    }
+    
+    size_t size() const { return size_; }
+
+private:
+    struct Entry 
+    {
+        Student student;
+        int score;
+        uint32_t slot;      // position inside the score bucket
+        bool alive;
+    };
+
+    int max_score_;
+    std::vector<uint32_t> tree_;                    // 1-based, position p counts score max_score_ - p + 1
+    std::vector<std::vector<StudentId>> buckets_;   // ids by total score, unordered within a bucket
+    std::vector<Entry> entries_;
+    std::vector<StudentId> free_ids_;
+    size_t size_ = 0;
+
+    bool valid_score(const int score) const
+    {
+        return score >= 0 && score <= max_score_;
+    }
+
+    // Better scores get smaller positions, so a prefix sum counts the students above
+    size_t position_of(const int score) const
+    {
+        return static_cast<size_t>(max_score_ - score) + 1;
+    }
+
+    void add(size_t position, const int delta)
+    {
+        for (; position < tree_.size(); position += position & (~position + 1)) 
+        {
+            tree_[position] = static_cast<uint32_t>(static_cast<int64_t>(tree_[position]) + delta);
+        }
+    }
+
+    size_t count_better(const int score) const
+    {
+        size_t count = 0;
+        for (size_t position = position_of(score) - 1; position > 0; position -= position & (~position + 1)) 
+        {
+            count += tree_[position];
+        }
+        return count;
+    }
+
+    void link(const StudentId id, const int score)
+    {
+        std::vector<StudentId>& bucket = buckets_[static_cast<size_t>(score)];
+        entries_[id].score = score;
+        entries_[id].slot = static_cast<uint32_t>(bucket.size());
+        entries_[id].alive = true;
+        bucket.push_back(id);
+        add(position_of(score), 1);
+    }
+
+    // Swap-with-last removal keeps buckets dense
+    void unlink(const StudentId id)
+    {
+        Entry& entry = entries_[id];
+        std::vector<StudentId>& bucket = buckets_[static_cast<size_t>(entry.score)];
+        const StudentId moved = bucket.back();
+        bucket[entry.slot] = moved;
+        entries_[moved].slot = entry.slot;
+        bucket.pop_back();
+        entry.alive = false;
+        add(position_of(entry.score), -1);
+    }
+};
 
 // ------------------------------------------------------------
 // Display Functions
@@ -359,8 +2169,9 @@ void display_instructions()
     
     std::cout << "File operations:\n";
     std::cout << "- Reads student data from '" << INPUT_FILENAME << "'\n";
-    std::cout << "- Sorts students by total score (selection sort)\n";
+    std::cout << "- Sorts students by total score (stable counting sort)\n";
     std::cout << "- Writes sorted data to '" << OUTPUT_FILENAME << "'\n";
+    std::cout << "- Files over " << (IN_MEMORY_SORT_LIMIT >> 20) << " MiB are sorted externally in runs on disk\n";
     std::cout << "================================================\n\n";
 }
 
@@ -446,6 +2257,121 @@ void demonstrate_primitive_vector_sorting()
     std::cout << "\n";
 }
 
+void demonstrate_columnar_table()
+{
+    std::cout << "\n=== Demonstrating Columnar Student Table ===\n";
+    
+    const std::pair<std::string, StudentTable> file_data = read_table_from_file(INPUT_FILENAME);
+    const StudentTable& table = file_data.second;
+    
+    std::cout << "Students: " << table.size() << "\n";
+    std::cout << "Distinct names: " << table.names().count() 
+              << " (" << table.names().byte_size() << " bytes)\n";
+    std::cout << "Marks column: " << table.marks_column().size() << " bytes\n";
+    std::cout << "Average total score: " << table.average_total_score() << "\n";
+    
+    if (table.size() > 0) 
+    {
+        const Date born = table.birth_date(0);
+        std::cout << "First record: " << table.last_name(0) << " " << table.first_name(0) 
+                  << ", born " << born.day << "." << born.month << "." << born.year 
+                  << ", total " << table.total_score(0) << "\n";
+    }
+}
+
+void demonstrate_score_queries()
+{
+    std::cout << "\n=== Demonstrating Streaming Score Queries ===\n";
+    
+    const std::vector<Student> best = stream_top_k(INPUT_FILENAME, 2, true);
+    std::cout << "Top 2 students:\n";
+    for (const auto& student : best) 
+    {
+        std::cout << "  ";
+        student.print_info();
+    }
+    
+    const std::vector<Student> worst = stream_top_k(INPUT_FILENAME, 1, false);
+    std::cout << "Bottom student:\n";
+    for (const auto& student : worst) 
+    {
+        std::cout << "  ";
+        student.print_info();
+    }
+    
+    const ScoreHistogram histogram = stream_score_histogram(INPUT_FILENAME);
+    if (histogram.size() > 0) 
+    {
+        const int score = 23;
+        std::cout << "Score " << score << ": rank " << histogram.rank(score) 
+                  << " of " << histogram.size() << ", percentile " << histogram.percentile(score) << "\n";
+        std::cout << "Median total score: " << histogram.score_at_percentile(50.0) << "\n";
+    }
+}
+
+std::string read_whole_file(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Forces several tiny runs so the spill and loser-tree merge path runs even on a small input,
+// then checks the report against the one produced by the in-memory sort
+void demonstrate_external_sort()
+{
+    std::cout << "\n=== Demonstrating External Merge Sort ===\n";
+    
+    const size_t run_records = 2;
+    const std::filesystem::path report = std::filesystem::temp_directory_path() / "students_external_report.txt";
+    
+    if (!external_sort_file(INPUT_FILENAME, report.string(), run_records)) 
+    {
+        std::cout << "External sort failed.\n";
+        return;
+    }
+    
+    const bool same = read_whole_file(report.string()) == read_whole_file(OUTPUT_FILENAME);
+    std::cout << "Sorted in runs of " << run_records << " records: report " 
+              << (same ? "matches" : "differs from") << " '" << OUTPUT_FILENAME << "'\n";
+    
+    std::error_code error;
+    std::filesystem::remove(report, error);
+}
+
+void demonstrate_live_ranking(const std::vector<Student>& students)
+{
+    std::cout << "\n=== Demonstrating Live Ranking Index ===\n";
+    
+    ScoreRankIndex index;
+    std::vector<ScoreRankIndex::StudentId> ids;
+    for (const auto& student : students) 
+    {
+        const ScoreRankIndex::StudentId id = index.insert(student);
+        if (id == ScoreRankIndex::INVALID_ID) 
+        {
+            std::cout << "Skipped " << student.lastName << ": total score " 
+                      << student.calculate_total_score() << " is out of range\n";
+            continue;
+        }
+        ids.push_back(id);
+    }
+    
+    for (const auto id : ids) 
+    {
+        std::cout << "Rank " << index.rank(id) << ": " << index.student(id).lastName 
+                  << " (" << index.score(id) << ")\n";
+    }
+    
+    if (ids.empty()) return;
+
+    const ScoreRankIndex::StudentId last = index.kth(index.size());
+    const int perfect_marks[SUBJECT_COUNT] = {5, 5, 5, 5, 5};
+    index.update_marks(last, perfect_marks);
+    
+    std::cout << "After " << index.student(last).lastName << " got all fives: rank " 
+              << index.rank(last) << ", best is now " << index.student(index.kth(1)).lastName << "\n";
+}
+
 // ------------------------------------------------------------
 // Main Program
 // ------------------------------------------------------------
@@ -464,6 +2390,30 @@ int main()
     
     // Student data processing
     std::cout << "\n\n=== Processing Student Data ===\n";
+    
+    // Files that may not fit in memory never get loaded whole: they are sorted in runs on disk
+    std::error_code size_error;
+    const uintmax_t input_size = std::filesystem::file_size(INPUT_FILENAME, size_error);
+    if (!size_error && input_size > IN_MEMORY_SORT_LIMIT) 
+    {
+        std::cout << "'" << INPUT_FILENAME << "' is " << (input_size >> 20) << " MiB, sorting externally...\n";
+        if (!external_sort_file(INPUT_FILENAME, OUTPUT_FILENAME)) 
+        {
+            std::cout << "\nError: External sort failed.\n";
+            return 1;
+        }
+        std::cout << "Results successfully saved to '" << OUTPUT_FILENAME << "'.\n";
+        
+        demonstrate_score_queries();
+        
+        std::cout << "\n================================================\n";
+        std::cout << "Program completed successfully!\n";
+        std::cout << "Press Enter to exit...";
+        std::cin.get();
+        
+        return 0;
+    }
+    
     std::cout << "Reading from '" << INPUT_FILENAME << "'...\n";
     
     const std::pair<std::string, std::vector<Student>> file_data = read_from_file(INPUT_FILENAME);
@@ -496,6 +2446,8 @@ int main()
     write_to_file(OUTPUT_FILENAME, group_number, students);
     std::cout << "Results successfully saved.\n";
     
+    demonstrate_external_sort();
+    
     // Demonstrate array of Students sorting
     std::cout << "\n=== Demonstrating Student Array Sorting ===\n";
     if (students.size() >= 3) 
@@ -523,6 +2475,10 @@ int main()
         }
     }
     
+    demonstrate_columnar_table();
+    demonstrate_score_queries();
+    demonstrate_live_ranking(students);
+    
     std::cout << "\n================================================\n";
     std::cout << "Program completed successfully!\n";
     std::cout << "Press Enter to exit...";
@@ -5,11 +5,15 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 #include <thread>
 #include <future>
 #include <atomic>
 #include <locale>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <variant>
 #include <memory>
 #include <vector>
 #include <numeric>
@@ -22,6 +26,65 @@
 
 const double PI = std::acos(-1.0);
 
+class UnitCircleTable {
+    std::vector<double> cos_;
+    std::vector<double> sin_;
+
+    public:
+        explicit UnitCircleTable(size_t segments) : cos_(segments), sin_(segments) {
+            for (size_t i = 0; i < segments; ++i) {
+                double angle = 2.0 * PI * i / segments;
+                cos_[i] = std::cos(angle);
+                sin_[i] = std::sin(angle);
+            }
+        }
+
+        size_t size() const noexcept { return cos_.size(); }
+        const double* cos_data() const noexcept { return cos_.data(); }
+        const double* sin_data() const noexcept { return sin_.data(); }
+
+        // Таблица строится один раз на количество сегментов и живет до конца программы
+        static const UnitCircleTable& get(size_t segments) {
+            thread_local const UnitCircleTable* last = nullptr;
+            if (last && last->size() == segments) {
+                return *last;
+            }
+
+            static std::mutex mtx;
+            static std::unordered_map<size_t, std::unique_ptr<UnitCircleTable>> cache;
+            std::lock_guard<std::mutex> lock(mtx);
+            auto& slot = cache[segments];
+            if (!slot) {
+                slot = std::make_unique<UnitCircleTable>(segments);
+            }
+            last = slot.get();
+            return *last;
+        }
+};
+
+struct BoundaryPointsSoA {
+    std::vector<double> x;
+    std::vector<double> y;
+
+    void resize(size_t count) {
+        x.resize(count);
+        y.resize(count);
+    }
+
+    size_t size() const noexcept { return x.size(); }
+};
+
+inline void fill_ellipse_points(double cx, double cy, double rx, double ry,
+                                const UnitCircleTable& table, double* xs, double* ys) {
+    const double* c = table.cos_data();
+    const double* s = table.sin_data();
+    const size_t n = table.size();
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] = cx + rx * c[i];
+        ys[i] = cy + ry * s[i];
+    }
+}
+
 class Barrier {
     std::mutex mtx_;
     std::condition_variable cv_;
@@ -55,6 +118,30 @@ struct OptionalDouble {
 
 namespace Geometry3D {
 
+    // Пишет текст в буфер вызывающего без выделения памяти; не поместившееся отбрасывается
+    class ShapeTextWriter
+    {
+        char *begin_;
+        char *pos_;
+        char *end_;
+
+        public:
+            ShapeTextWriter(char *buffer, size_t size) : begin_(buffer), pos_(buffer), end_(buffer + size) {}
+
+            void write(std::string_view text) {
+                const size_t count = std::min(text.size(), static_cast<size_t>(end_ - pos_));
+                pos_ = std::copy_n(text.data(), count, pos_);
+            }
+
+            // Шесть значащих цифр, как у operator<< с настройками потока по умолчанию
+            void write(double value) {
+                auto result = std::to_chars(pos_, end_, value, std::chars_format::general, 6);
+                if (result.ec == std::errc()) pos_ = result.ptr;
+            }
+
+            size_t size() const noexcept { return static_cast<size_t>(pos_ - begin_); }
+    };
+
     template<typename Derived>
     class ShapeCRTP {
         public:
@@ -206,16 +293,39 @@ namespace Geometry3D {
                 }
                 
                 auto get_boundary_points(size_t segments) const {
+                    const UnitCircleTable& table = UnitCircleTable::get(segments);
+                    const double rx = width_ / 2.0, ry = height_ / 2.0;
+                    const double cx = top_left_.get<0>() + rx, cy = top_left_.get<1>() + ry;
                     std::vector<PointType> points;
+                    points.reserve(segments);
                     for (size_t i = 0; i < segments; ++i) {
-                        double angle = 2.0 * PI * i / segments;
-                        points.emplace_back(
-                            top_left_.get<0>() + width_/2.0 + width_/2.0 * std::cos(angle),
-                            top_left_.get<1>() + height_/2.0 + height_/2.0 * std::sin(angle)
-                        );
+                        points.emplace_back(cx + rx * table.cos_data()[i], cy + ry * table.sin_data()[i]);
                     }
                     return points;
                 }
+
+                void fill_boundary_points(const UnitCircleTable& table, double* xs, double* ys) const {
+                    const double rx = width_ / 2.0, ry = height_ / 2.0;
+                    fill_ellipse_points(top_left_.get<0>() + rx, top_left_.get<1>() + ry, rx, ry, table, xs, ys);
+                }
+
+                BoundaryPointsSoA get_boundary_points_soa(size_t segments) const {
+                    BoundaryPointsSoA result;
+                    result.resize(segments);
+                    fill_boundary_points(UnitCircleTable::get(segments), result.x.data(), result.y.data());
+                    return result;
+                }
+
+                // Точки фигуры i занимают диапазон [i * segments, (i + 1) * segments)
+                static BoundaryPointsSoA generate_boundaries(const std::vector<AdvancedRectangle>& shapes, size_t segments) {
+                    BoundaryPointsSoA result;
+                    result.resize(shapes.size() * segments);
+                    const UnitCircleTable& table = UnitCircleTable::get(segments);
+                    for (size_t i = 0; i < shapes.size(); ++i) {
+                        shapes[i].fill_boundary_points(table, result.x.data() + i * segments, result.y.data() + i * segments);
+                    }
+                    return result;
+                }
                 
                 double parallel_area() const {
                     auto concurrency = std::thread::hardware_concurrency();
@@ -237,44 +347,39 @@ namespace Geometry3D {
                     return this->serialize_impl(*this);
                 }
                 
-                struct ShapeVariant {
-
-                    enum Type { 
-                        Rectangle, 
-                        Number, 
-                        Str 
-                    };
-
-                    Type type;
-                    AdvancedRectangle rect;
-                    double num;
-                    std::string str;
-                    ShapeVariant(const AdvancedRectangle& r) : type(Rectangle), rect(r) 
-                    {
+                // Хранится только одна альтернатива: размер - наибольшая из них плюс тег
+                using ShapeVariant = std::variant<AdvancedRectangle, double, std::string>;
 
-                    }
-                    ShapeVariant(double n) : type(Number), num(n) 
-                    {
+                template <typename Visitor>
+                static decltype(auto) visit_shape(const ShapeVariant &shape, Visitor &&visitor) {
+                    return std::visit(std::forward<Visitor>(visitor), shape);
+                }
 
-                    }
-                    ShapeVariant(const std::string& s) : type(Str), str(s) 
-                    {
+                // Описание фигуры в буфер вызывающего, возвращает число записанных байт
+                static size_t describe_shape(const ShapeVariant &shape, char *buffer, size_t size) {
+                    ShapeTextWriter out(buffer, size);
+                    visit_shape(shape, [&out](const auto &value) {
+                        using T = std::decay_t<decltype(value)>;
+                        if constexpr (std::is_same_v<T, AdvancedRectangle>) {
+                            out.write("Прямоугольник с площадью: ");
+                            out.write(value.area_impl());
+                        } else if constexpr (std::is_same_v<T, double>) {
+                            out.write("Число: ");
+                            out.write(value);
+                        } else {
+                            out.write("Строка: ");
+                            out.write(value);
+                        }
+                    });
+                    return out.size();
+                }
 
+                static std::string match_shape(const ShapeVariant &shape) {
+                    if (const std::string *str = std::get_if<std::string>(&shape)) {
+                        return "Строка: " + *str;
                     }
-                };
-                static std::string match_shape(const ShapeVariant& shape) {
-                    std::ostringstream oss;
-                    switch (shape.type) {
-                        case ShapeVariant::Rectangle:
-                            oss << "Прямоугольник с площадью: " << shape.rect.area_impl();
-                            return oss.str();
-                        case ShapeVariant::Number:
-                            oss << "Число: " << shape.num;
-                            return oss.str();
-                        case ShapeVariant::Str:
-                            return "Строка: " + shape.str;
-                    }
-                    return "";
+                    char buffer[96];
+                    return std::string(buffer, describe_shape(shape, buffer, sizeof(buffer)));
                 }
                 
                 static constexpr double golden_ratio() {
@@ -2,9 +2,47 @@
 #include <iostream>
 #include <cmath>
 
-Barrier::Barrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace {
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+Barrier::Barrier(size_t count) : remaining_(count), phase_(0), count_(count) {
+    // Если потоков больше, чем ядер, ожидание в цикле только отнимает время у остальных
+    size_t hardware = std::thread::hardware_concurrency();
+    spin_limit_ = (hardware != 0 && count <= hardware) ? 4096 : 0;
+}
 
 void Barrier::arrive_and_wait() {
+    const uint32_t phase = phase_.load(std::memory_order_acquire);
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        remaining_.store(count_, std::memory_order_relaxed);
+        phase_.store(phase + 1, std::memory_order_release);
+        phase_.notify_all();
+        return;
+    }
+
+    for (unsigned i = 0; i < spin_limit_; ++i) {
+        if (phase_.load(std::memory_order_acquire) != phase) return;
+        cpu_relax();
+    }
+    while (phase_.load(std::memory_order_acquire) == phase) {
+        phase_.wait(phase, std::memory_order_acquire);
+    }
+}
+
+MutexBarrier::MutexBarrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+
+void MutexBarrier::arrive_and_wait() {
     std::unique_lock<std::mutex> lock(mtx_);
     size_t gen = generation_;
     ++waiting_;
@@ -32,15 +70,234 @@ namespace Geometry3D {
         return OptionalDouble();
     }
 
+    namespace {
+        void throw_validation_error(uint8_t errors) {
+            if (errors & NonPositiveSize) {
+                throw std::invalid_argument("Размеры должны быть положительными");
+            }
+            if (errors & SizeTooLarge) {
+                throw std::overflow_error("Размеры слишком большие");
+            }
+            if (errors & NonFiniteValue) {
+                throw std::invalid_argument("Размеры должны быть конечными числами");
+            }
+        }
+    }
+
     void StrictValidation::validate(double w, double h) const {
-        if (w <= 0.0 || h <= 0.0) {
-            throw std::invalid_argument("Размеры должны быть положительными");
+        if (uint8_t errors = check(w, h)) {
+            throw_validation_error(errors);
         }
-        if (w > 1e6 || h > 1e6) {
-            throw std::overflow_error("Размеры слишком большие");
+    }
+
+    size_t StrictValidation::validate_batch(std::span<const double> widths, std::span<const double> heights,
+                                            std::span<uint8_t> errors) {
+        if (widths.size() != heights.size() || errors.size() != widths.size()) {
+            throw std::invalid_argument("Размеры массивов для проверки не совпадают");
         }
+        size_t invalid = 0;
+        for (size_t i = 0; i < widths.size(); ++i) {
+            const uint8_t mask = check(widths[i], heights[i]);
+            errors[i] = mask;
+            invalid += mask != 0;
+        }
+        return invalid;
     }
     
+    StageScheduler::StageScheduler(size_t worker_count) {
+        if (worker_count == 0) {
+            size_t hardware = std::thread::hardware_concurrency();
+            worker_count = hardware > 1 ? hardware - 1 : 1;
+        }
+        ensure_workers(worker_count);
+    }
+
+    StageScheduler::~StageScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    void StageScheduler::ensure_workers(size_t count) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        while (workers_.size() < count) {
+            workers_.emplace_back(&StageScheduler::worker_loop, this, generation_);
+        }
+    }
+
+    void StageScheduler::worker_loop(size_t seen) {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                work_cv_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+                job = job_;
+            }
+            if (job) {
+                run_job(*job);
+            }
+        }
+    }
+
+    void StageScheduler::run_job(Job& job) {
+        for (;;) {
+            size_t begin = job.next.fetch_add(job.grain, std::memory_order_relaxed);
+            if (begin >= job.count) return;
+            size_t end = std::min(begin + job.grain, job.count);
+
+            try {
+                (*job.body)(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!job.error) job.error = std::current_exception();
+            }
+
+            if (job.done.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == job.count) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                done_cv_.notify_all();
+            }
+            if (job.one_per_thread) return;
+        }
+    }
+
+    void StageScheduler::dispatch(const RangeBody& body, size_t count, size_t grain, bool one_per_thread) {
+        if (count == 0) return;
+
+        auto job = std::make_shared<Job>();
+        job->body = &body;
+        job->count = count;
+        job->grain = grain;
+        job->one_per_thread = one_per_thread;
+        bool published = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!job_) {
+                job_ = job;
+                ++generation_;
+                published = true;
+            }
+        }
+
+        if (published) {
+            work_cv_.notify_all();
+            run_job(*job);
+
+            std::unique_lock<std::mutex> lock(mtx_);
+            done_cv_.wait(lock, [&job] { return job->done.load(std::memory_order_acquire) == job->count; });
+            job_.reset();
+        } else {
+            // Пул занят другим заданием (вызов из задачи или из другого потока): обычное задание
+            // вызывающий поток выполняет сам, а задачам с барьером даются временные потоки
+            std::vector<std::thread> helpers;
+            if (one_per_thread) {
+                for (size_t i = 1; i < count; ++i) {
+                    helpers.emplace_back([this, job] { run_job(*job); });
+                }
+            }
+            run_job(*job);
+            for (auto& helper : helpers) {
+                helper.join();
+            }
+        }
+
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+    void StageScheduler::run_concurrently(size_t count, const std::function<void(size_t)>& body) {
+        if (count > 1) {
+            ensure_workers(count - 1);
+        }
+        RangeBody range = [&body](size_t begin, size_t) { body(begin); };
+        dispatch(range, count, 1, true);
+    }
+
+    size_t StageScheduler::add_stage(std::string name, size_t task_count, std::function<void(size_t)> body,
+                                     std::vector<size_t> dependencies) {
+        for (size_t dep : dependencies) {
+            if (dep >= stages_.size()) {
+                throw std::out_of_range("Зависимость на несуществующий этап");
+            }
+        }
+        stages_.push_back({std::move(name), task_count, std::move(body), std::move(dependencies)});
+        return stages_.size() - 1;
+    }
+
+    void StageScheduler::clear_stages() {
+        stages_.clear();
+    }
+
+    std::vector<StageTiming> StageScheduler::run() {
+        using Clock = std::chrono::steady_clock;
+
+        // Этапы одного уровня не зависят друг от друга и выполняются одним parallel_for
+        std::vector<size_t> level(stages_.size(), 0);
+        size_t level_count = 0;
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            for (size_t dep : stages_[s].dependencies) {
+                level[s] = std::max(level[s], level[dep] + 1);
+            }
+            level_count = std::max(level_count, level[s] + 1);
+        }
+
+        std::vector<Clock::time_point> start(stages_.size());
+        std::vector<Clock::time_point> finish(stages_.size());
+        std::unique_ptr<std::atomic<size_t>[]> remaining(new std::atomic<size_t>[stages_.size()]);
+        std::unique_ptr<std::atomic<bool>[]> started(new std::atomic<bool>[stages_.size()]);
+
+        for (size_t current = 0; current < level_count; ++current) {
+            std::vector<size_t> wave;
+            std::vector<size_t> offsets{0};
+            for (size_t s = 0; s < stages_.size(); ++s) {
+                if (level[s] != current) continue;
+                wave.push_back(s);
+                offsets.push_back(offsets.back() + stages_[s].task_count);
+                remaining[s].store(stages_[s].task_count, std::memory_order_relaxed);
+                started[s].store(false, std::memory_order_relaxed);
+                start[s] = finish[s] = Clock::now();
+            }
+
+            RangeBody range = [&](size_t begin, size_t end) {
+                size_t w = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+                while (begin < end) {
+                    const size_t s = wave[w];
+                    const size_t stop = std::min(end, offsets[w + 1]);
+                    if (!started[s].exchange(true, std::memory_order_relaxed)) {
+                        start[s] = Clock::now();
+                    }
+                    for (size_t i = begin; i < stop; ++i) {
+                        stages_[s].body(i - offsets[w]);
+                    }
+                    if (remaining[s].fetch_sub(stop - begin, std::memory_order_acq_rel) == stop - begin) {
+                        finish[s] = Clock::now();
+                    }
+                    begin = stop;
+                    ++w;
+                }
+            };
+
+            const size_t total = offsets.back();
+            const size_t grain = std::max<size_t>(1, total / ((workers_.size() + 1) * 8));
+            dispatch(range, total, grain, false);
+        }
+
+        std::vector<StageTiming> timings;
+        timings.reserve(stages_.size());
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            timings.push_back({stages_[s].name, stages_[s].task_count,
+                               std::chrono::duration<double, std::milli>(finish[s] - start[s]).count()});
+        }
+        return timings;
+    }
+
     void ThreadManager::safe_print(int thread_id, const std::string& message) {
         std::lock_guard<std::mutex> lock(cout_mutex_);
         std::cout << "   Поток " << thread_id << ": " << message << std::endl;
@@ -48,16 +305,12 @@ namespace Geometry3D {
 
     void ThreadManager::execute_sequentially(std::function<void(int)> task, int count, const std::string& stage_name) {
         std::cout << "\n   Этап \"" << stage_name << "\":" << std::endl;
-        
+
+        // Задачи идут строго по очереди, поэтому отдельный поток для каждой не нужен
         for (int i = 0; i < count; ++i) {
-            std::thread t([this, i, &task]() {
-                safe_print(i, "начал работу");
-                task(i);
-                safe_print(i, "завершил работу");
-            });
-            
-            t.join(); 
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            safe_print(i, "начал работу");
+            task(i);
+            safe_print(i, "завершил работу");
         }
         
         std::cout << "   Все потоки завершили этап \"" << stage_name << "\"" << std::endl;
@@ -67,22 +320,12 @@ namespace Geometry3D {
         std::cout << "\n   Этап \"" << stage_name << "\":" << std::endl;
         
         Barrier barrier(count);
-        std::vector<std::thread> parallel_threads;
-        
-        for (int i = 0; i < count; ++i) {
-            parallel_threads.emplace_back([this, i, &barrier, &task]() {
-                safe_print(i, "начал подготовку");
-                std::this_thread::sleep_for(std::chrono::milliseconds(100 * (i + 1)));
-                
-                task(i, barrier);
-                
-                safe_print(i, "завершил работу");
-            });
-        }
-        
-        for (auto& t : parallel_threads) {
-            t.join();
-        }
+        scheduler_.run_concurrently(static_cast<size_t>(count), [this, &barrier, &task](size_t index) {
+            int i = static_cast<int>(index);
+            safe_print(i, "начал подготовку");
+            task(i, barrier);
+            safe_print(i, "завершил работу");
+        });
         
         std::cout << "   Все потоки синхронизированы" << std::endl;
     }
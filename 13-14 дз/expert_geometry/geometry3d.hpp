@@ -4,11 +4,16 @@
 #include <condition_variable>
 #include <type_traits>
 #include <filesystem>
+#include <functional>
+#include <exception>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <numeric>
+#include <cstdint>
+#include <limits>
+#include <span>
 #include <memory>
 #include <vector>
 #include <chrono>
@@ -17,12 +22,31 @@
 #include <future>
 #include <atomic>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <variant>
 #include <array>
 #include <cmath>
 #include <mutex>
 #include <any>
 
+// Барьер со сменой фазы: прибывший поток крутится недолго, затем засыпает на atomic::wait
 class Barrier
+{
+    static constexpr size_t cache_line = 64;
+
+    alignas(cache_line) std::atomic<size_t> remaining_;
+    alignas(cache_line) std::atomic<uint32_t> phase_;
+    alignas(cache_line) size_t count_;
+    unsigned spin_limit_;
+
+    public:
+        explicit Barrier(size_t count);
+        void arrive_and_wait();
+};
+
+// Прежний барьер на мьютексе и condition_variable, оставлен для сравнения
+class MutexBarrier
 {
     std::mutex mtx_;
     std::condition_variable cv_;
@@ -31,7 +55,7 @@ class Barrier
     size_t generation_;
 
     public:
-        explicit Barrier(size_t count);
+        explicit MutexBarrier(size_t count);
         void arrive_and_wait();
 };
 
@@ -96,6 +120,30 @@ namespace Geometry3D
             }
     };
 
+    // Пишет текст в буфер вызывающего без выделения памяти; не поместившееся отбрасывается
+    class ShapeTextWriter
+    {
+        char *begin_;
+        char *pos_;
+        char *end_;
+
+        public:
+            ShapeTextWriter(char *buffer, size_t size) : begin_(buffer), pos_(buffer), end_(buffer + size) {}
+
+            void write(std::string_view text) {
+                const size_t count = std::min(text.size(), static_cast<size_t>(end_ - pos_));
+                pos_ = std::copy_n(text.data(), count, pos_);
+            }
+
+            // Шесть значащих цифр, как у operator<< с настройками потока по умолчанию
+            void write(double value) {
+                auto result = std::to_chars(pos_, end_, value, std::chars_format::general, 6);
+                if (result.ec == std::errc()) pos_ = result.ptr;
+            }
+
+            size_t size() const noexcept { return static_cast<size_t>(pos_ - begin_); }
+    };
+
     template <typename Derived>
     class ShapeCRTP
     {
@@ -189,6 +237,11 @@ namespace Geometry3D
                 return access_count_.load(std::memory_order_relaxed);
             }
 
+            // {min_x, min_y, max_x, max_y}; счетчик обращений не увеличивается
+            std::array<double, 4> bounds() const noexcept {
+                return {top_left_[0], top_left_[1], top_left_[0] + width_, top_left_[1] + height_};
+            }
+
             OptionalDouble safe_divide(double numerator) const {
                 if (std::fabs(width_) < 1e-10 || std::fabs(height_) < 1e-10) {
                     return OptionalDouble();
@@ -269,46 +322,39 @@ namespace Geometry3D
                 return result;
             }
 
-            struct ShapeVariant
-            {
-                enum Type { 
-                    Rectangle, 
-                    Number, 
-                    Str 
-                };
-
-                Type type;
-                AdvancedRectangle rect;
-                double num;
-                std::string str;
-
-                ShapeVariant(const AdvancedRectangle& r) : type(Rectangle), rect(r) 
-                {
-
-                }
-                ShapeVariant(double n) : type(Number), num(n) 
-                {
+            // Хранится только одна альтернатива: размер - наибольшая из них плюс тег
+            using ShapeVariant = std::variant<AdvancedRectangle, double, std::string>;
 
-                }
-                ShapeVariant(const std::string& s) : type(Str), str(s) 
-                {
+            template <typename Visitor>
+            static decltype(auto) visit_shape(const ShapeVariant &shape, Visitor &&visitor) {
+                return std::visit(std::forward<Visitor>(visitor), shape);
+            }
 
-                }
-            };
+            // Описание фигуры в буфер вызывающего, возвращает число записанных байт
+            static size_t describe_shape(const ShapeVariant &shape, char *buffer, size_t size) {
+                ShapeTextWriter out(buffer, size);
+                visit_shape(shape, [&out](const auto &value) {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, AdvancedRectangle>) {
+                        out.write("Прямоугольник с площадью: ");
+                        out.write(value.area_impl());
+                    } else if constexpr (std::is_same_v<T, double>) {
+                        out.write("Число: ");
+                        out.write(value);
+                    } else {
+                        out.write("Строка: ");
+                        out.write(value);
+                    }
+                });
+                return out.size();
+            }
 
             static std::string match_shape(const ShapeVariant &shape) {
-                std::ostringstream oss;
-                switch (shape.type) {
-                    case ShapeVariant::Rectangle:
-                        oss << "Прямоугольник с площадью: " << shape.rect.area_impl();
-                        return oss.str();
-                    case ShapeVariant::Number:
-                        oss << "Число: " << shape.num;
-                        return oss.str();
-                    case ShapeVariant::Str:
-                        return "Строка: " + shape.str;
+                if (const std::string *str = std::get_if<std::string>(&shape)) {
+                    return "Строка: " + *str;
                 }
-                return "";
+                char buffer[96];
+                return std::string(buffer, describe_shape(shape, buffer, sizeof(buffer)));
             }
 
         private:
@@ -323,9 +369,39 @@ namespace Geometry3D
         OptionalDouble get_cached() const;
     };
 
+    // Биты маски ошибок проверки; 0 - запись корректна
+    enum ValidationError : uint8_t
+    {
+        ValidationOk = 0,
+        NonPositiveSize = 1 << 0,
+        SizeTooLarge = 1 << 1,
+        NonFiniteValue = 1 << 2,
+    };
+
     struct StrictValidation
     {
+        static constexpr double max_size = 1e6;
+
+        // Маска ошибок без ветвлений и исключений
+        static uint8_t check(double w, double h) noexcept {
+            const double limit = std::numeric_limits<double>::max();
+            return static_cast<uint8_t>(
+                ((w <= 0.0) | (h <= 0.0)) * NonPositiveSize
+              | ((w > max_size) | (h > max_size)) * SizeTooLarge
+              | (!(std::fabs(w) <= limit) | !(std::fabs(h) <= limit)) * NonFiniteValue);
+        }
+
         void validate(double w, double h) const;
+
+        // Пакетная проверка: errors[i] получает маску i-й записи, возвращается число некорректных
+        static size_t validate_batch(std::span<const double> widths, std::span<const double> heights,
+                                     std::span<uint8_t> errors);
+    };
+
+    // Проверка отключена: для доверенных данных на горячих путях
+    struct NoValidation
+    {
+        void validate(double, double) const noexcept {}
     };
 
     struct JSONSerialization
@@ -399,17 +475,119 @@ namespace Geometry3D
                 auto end = std::chrono::high_resolution_clock::now();
                 return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
             }
+
+            // Среднее время одной фазы барьера в микросекундах
+            template <typename BarrierType>
+            static double measure_barrier(size_t threads, size_t phases = 1000)
+            {
+                BarrierType barrier(threads);
+                std::vector<std::thread> workers;
+                workers.reserve(threads - 1);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                for (size_t t = 1; t < threads; ++t) {
+                    workers.emplace_back([&barrier, phases]() {
+                        for (size_t p = 0; p < phases; ++p) barrier.arrive_and_wait();
+                    });
+                }
+                for (size_t p = 0; p < phases; ++p) barrier.arrive_and_wait();
+                for (auto& w : workers) w.join();
+                auto end = std::chrono::high_resolution_clock::now();
+
+                return std::chrono::duration<double, std::micro>(end - start).count() / phases;
+            }
+    };
+
+    struct StageTiming
+    {
+        std::string name;
+        size_t task_count;
+        double milliseconds;
+    };
+
+    class StageScheduler
+    {
+        using RangeBody = std::function<void(size_t, size_t)>;
+
+        struct Job
+        {
+            const RangeBody *body = nullptr;
+            size_t count = 0;
+            size_t grain = 1;
+            bool one_per_thread = false;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::exception_ptr error;
+        };
+
+        struct Stage
+        {
+            std::string name;
+            size_t task_count;
+            std::function<void(size_t)> body;
+            std::vector<size_t> dependencies;
+        };
+
+        std::vector<std::thread> workers_;
+        std::mutex mtx_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        std::shared_ptr<Job> job_;
+        size_t generation_ = 0;
+        bool stopping_ = false;
+        std::vector<Stage> stages_;
+
+        void worker_loop(size_t seen);
+        void run_job(Job &job);
+        void dispatch(const RangeBody &body, size_t count, size_t grain, bool one_per_thread);
+
+        public:
+            // 0 - по числу аппаратных потоков; вызывающий поток тоже участвует в работе
+            explicit StageScheduler(size_t worker_count = 0);
+            ~StageScheduler();
+
+            StageScheduler(const StageScheduler &) = delete;
+            StageScheduler &operator=(const StageScheduler &) = delete;
+
+            size_t worker_count() const noexcept { return workers_.size(); }
+            void ensure_workers(size_t count);
+
+            template <typename Body>
+            void parallel_for(size_t count, Body &&body)
+            {
+                const size_t participants = workers_.size() + 1;
+                const size_t grain = std::max<size_t>(1, count / (participants * 8));
+                RangeBody range = [&body](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        body(i);
+                    }
+                };
+                dispatch(range, count, grain, false);
+            }
+
+            // Каждый индекс выполняется в отдельном потоке, все одновременно (нужно для барьеров).
+            // Если пул уже занят, например при вызове из задачи, недостающие потоки создаются временно
+            void run_concurrently(size_t count, const std::function<void(size_t)> &body);
+
+            // Зависимости - номера ранее добавленных этапов
+            size_t add_stage(std::string name, size_t task_count, std::function<void(size_t)> body,
+                             std::vector<size_t> dependencies = {});
+            std::vector<StageTiming> run();
+            void clear_stages();
     };
 
     class ThreadManager
     {
         private:
             std::mutex cout_mutex_;
+            StageScheduler scheduler_;
             void safe_print(int thread_id, const std::string &message);
 
         public:
             void execute_sequentially(std::function<void(int)> task, int count, const std::string &stage_name);
             void execute_with_barrier(std::function<void(int, Barrier &)> task, int count, const std::string &stage_name);
+
+            StageScheduler &scheduler() { return scheduler_; }
     };
 
 } // namespace Geometry3D
@@ -1,4 +1,6 @@
 #include "geometry3d.hpp"
+#include "rect_index.hpp"
+#include "rect_coverage.hpp"
 #include <iostream>
 #include <locale>
 
@@ -109,6 +111,107 @@ int main() {
         std::cout << "   Площадь (через стирание типов): " << any_shape.area() << std::endl;
         std::cout << "   Периметр (через стирание типов): " << any_shape.perimeter() << std::endl;
         
+        std::cout << "\n14. Планировщик этапов с постоянными потоками:" << std::endl;
+        std::vector<AdvancedRectangle<HeapStorage, StrictValidation, JSONSerialization>> batch;
+        for (int i = 0; i < 64; ++i) {
+            batch.emplace_back(1.0 + i * 0.25, 2.0);
+        }
+        std::vector<double> areas(batch.size());
+        std::vector<double> ratios(batch.size());
+        double total_area = 0.0;
+        double mean_ratio = 0.0;
+
+        StageScheduler& scheduler = thread_manager.scheduler();
+        size_t area_stage = scheduler.add_stage("Площади", batch.size(), [&](size_t i) {
+            areas[i] = batch[i].area();
+        });
+        size_t ratio_stage = scheduler.add_stage("Соотношения", batch.size(), [&](size_t i) {
+            ratios[i] = batch[i].aspect_ratio().value;
+        });
+        scheduler.add_stage("Сумма", 1, [&](size_t) {
+            total_area = std::accumulate(areas.begin(), areas.end(), 0.0);
+            mean_ratio = std::accumulate(ratios.begin(), ratios.end(), 0.0) / static_cast<double>(ratios.size());
+        }, {area_stage, ratio_stage});
+
+        for (const auto& timing : scheduler.run()) {
+            std::cout << "   Этап \"" << timing.name << "\": " << timing.task_count
+                      << " задач, " << timing.milliseconds << " мс" << std::endl;
+        }
+        scheduler.clear_stages();
+        std::cout << "   Суммарная площадь: " << total_area << std::endl;
+        std::cout << "   Среднее соотношение сторон: " << mean_ratio << std::endl;
+        
+        std::cout << "\n15. Сравнение барьеров (мкс на фазу):" << std::endl;
+        for (size_t threads : {2, 4, 8, 16, 32, 64}) {
+            double atomic_time = Benchmark::measure_barrier<Barrier>(threads, 200);
+            double mutex_time = Benchmark::measure_barrier<MutexBarrier>(threads, 200);
+            std::cout << "   Потоков " << threads << ": атомарный " << atomic_time
+                      << ", мьютекс " << mutex_time << std::endl;
+        }
+
+        std::cout << "\n16. Пакетная проверка без исключений:" << std::endl;
+
+        std::vector<double> widths = {3.0, -1.0, 2e6, 4.0, std::nan("")};
+        std::vector<double> heights = {4.0, 2.0, 1.0, 0.0, 1.0};
+        std::vector<uint8_t> errors(widths.size());
+        size_t invalid = StrictValidation::validate_batch(widths, heights, errors);
+        std::cout << "   Некорректных записей: " << invalid << " из " << widths.size() << std::endl;
+        for (size_t i = 0; i < errors.size(); ++i) {
+            std::cout << "   Запись " << i << ": маска " << static_cast<int>(errors[i]) << std::endl;
+        }
+
+        AdvancedRectangle<HeapStorage, NoValidation, JSONSerialization> trusted(5.0, 6.0);
+        std::cout << "   Без проверки: " << trusted.serialize() << std::endl;
+
+        std::cout << "\n17. Пространственный индекс (R-дерево):" << std::endl;
+        std::vector<AdvancedRectangle<HeapStorage, NoValidation, JSONSerialization>> layout;
+        std::mt19937 layout_rng(42);
+        std::uniform_real_distribution<double> position(0.0, 1000.0), extent(0.5, 5.0);
+        for (int i = 0; i < 200000; ++i) {
+            layout.emplace_back(Point<double, 2>(position(layout_rng), position(layout_rng)),
+                                extent(layout_rng), extent(layout_rng));
+        }
+
+        RectIndex index;
+        auto build_start = std::chrono::high_resolution_clock::now();
+        index.build_from(layout, &scheduler);
+        auto build_end = std::chrono::high_resolution_clock::now();
+        std::cout << "   Построение " << layout.size() << " прямоугольников: "
+                  << std::chrono::duration<double, std::milli>(build_end - build_start).count()
+                  << " мс, высота " << index.height() << std::endl;
+
+        std::vector<RectIndex::Id> found;
+        index.query_window({100.0, 100.0, 120.0, 120.0}, found);
+        std::cout << "   В окне 20x20: " << found.size() << std::endl;
+        found.clear();
+        index.query_point(500.0, 500.0, found);
+        std::cout << "   Содержат точку (500, 500): " << found.size() << std::endl;
+        auto nearest = index.nearest(500.0, 500.0, 3);
+        std::cout << "   Ближайший к (500, 500): " << layout[nearest.front()].centroid() << std::endl;
+
+        for (RectIndex::Id id = 0; id < 1000; ++id) {
+            index.remove(id, layout[id].bounds());
+        }
+        std::cout << "   После удаления 1000 записей: " << index.size() << std::endl;
+
+        std::cout << "\n18. Покрытие набора прямоугольников (заметающая прямая):" << std::endl;
+        std::vector<Bounds2D> layout_bounds(layout.size());
+        for (size_t i = 0; i < layout.size(); ++i) {
+            layout_bounds[i] = layout[i].bounds();
+        }
+        double summed_area = 0.0;
+        for (const auto& r : layout) {
+            summed_area += r.area_impl();
+        }
+        auto sweep_start = std::chrono::high_resolution_clock::now();
+        CoverageReport coverage = analyze_coverage(layout_bounds, true, &scheduler);
+        auto sweep_end = std::chrono::high_resolution_clock::now();
+        std::cout << "   Сумма площадей: " << summed_area << std::endl;
+        std::cout << "   Площадь объединения: " << coverage.union_area << std::endl;
+        std::cout << "   Площадь попарных пересечений: " << coverage.overlap_area << std::endl;
+        std::cout << "   Пересекающихся пар: " << coverage.pairs.size() << ", "
+                  << std::chrono::duration<double, std::milli>(sweep_end - sweep_start).count() << " мс" << std::endl;
+        
     } catch (const std::exception& e) {
         std::cerr << "\nКритическая ошибка: " << e.what() << std::endl;
         return 1;
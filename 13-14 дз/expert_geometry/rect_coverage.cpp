@@ -0,0 +1,268 @@
+#include "rect_coverage.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Geometry3D {
+
+    namespace {
+        constexpr size_t slab_size = 1 << 14;
+        constexpr size_t max_slabs = 64;
+
+        // Дерево отрезков по элементарным интервалам сжатых y. Счетчик узла - число
+        // интервалов, назначенных ему целиком; он не проталкивается вниз, а агрегаты
+        // пересчитываются снизу вверх по пути обновления
+        class CoverageTree
+        {
+            const std::vector<double> &ys_;
+            size_t segments_;
+            std::vector<int> count_;
+            std::vector<double> covered_;   // длина, покрытая хотя бы раз
+            std::vector<double> sum1_;      // сумма length * k по поддереву
+            std::vector<double> sum2_;      // сумма length * k^2 по поддереву
+
+            void pull(size_t node, size_t lo, size_t hi) {
+                const double length = ys_[hi] - ys_[lo];
+                const double c = count_[node];
+                double child_covered = 0.0, s1 = 0.0, s2 = 0.0;
+                if (hi - lo > 1) {
+                    child_covered = covered_[2 * node] + covered_[2 * node + 1];
+                    s1 = sum1_[2 * node] + sum1_[2 * node + 1];
+                    s2 = sum2_[2 * node] + sum2_[2 * node + 1];
+                }
+                covered_[node] = count_[node] > 0 ? length : child_covered;
+                sum1_[node] = c * length + s1;
+                sum2_[node] = c * c * length + 2.0 * c * s1 + s2;
+            }
+
+            void update(size_t node, size_t lo, size_t hi, size_t a, size_t b, int delta) {
+                if (b <= lo || hi <= a) return;
+                if (a <= lo && hi <= b) {
+                    count_[node] += delta;
+                } else {
+                    const size_t mid = (lo + hi) / 2;
+                    update(2 * node, lo, mid, a, b, delta);
+                    update(2 * node + 1, mid, hi, a, b, delta);
+                }
+                pull(node, lo, hi);
+            }
+
+            public:
+                explicit CoverageTree(const std::vector<double> &ys)
+                    : ys_(ys), segments_(ys.size() - 1), count_(4 * segments_),
+                      covered_(4 * segments_), sum1_(4 * segments_), sum2_(4 * segments_) {}
+
+                void add(size_t a, size_t b, int delta) {
+                    if (a < b) update(1, 0, segments_, a, b, delta);
+                }
+
+                double covered() const { return covered_[1]; }
+                // Сумма k(k-1)/2 по длине: вклад текущего сечения в площадь попарных пересечений
+                double pair_length() const { return 0.5 * (sum2_[1] - sum1_[1]); }
+        };
+
+        // Максимум верхних границ активных прямоугольников по слотам, упорядоченным по нижней границе
+        class MaxEndTree
+        {
+            size_t leaves_ = 1;
+            std::vector<double> max_;
+
+            template <typename Callback>
+            void report(size_t node, size_t lo, size_t hi, size_t prefix, double threshold, Callback &callback) const {
+                if (lo >= prefix || max_[node] <= threshold) return;
+                if (hi - lo == 1) {
+                    callback(lo);
+                    return;
+                }
+                const size_t mid = (lo + hi) / 2;
+                report(2 * node, lo, mid, prefix, threshold, callback);
+                report(2 * node + 1, mid, hi, prefix, threshold, callback);
+            }
+
+            public:
+                explicit MaxEndTree(size_t slots) {
+                    while (leaves_ < slots) leaves_ *= 2;
+                    max_.assign(2 * leaves_, -std::numeric_limits<double>::infinity());
+                }
+
+                void set(size_t slot, double value) {
+                    size_t node = leaves_ + slot;
+                    max_[node] = value;
+                    for (node /= 2; node > 0; node /= 2) {
+                        max_[node] = std::max(max_[2 * node], max_[2 * node + 1]);
+                    }
+                }
+
+                // Вызывает callback для каждого слота из [0, prefix) со значением больше threshold
+                template <typename Callback>
+                void report(size_t prefix, double threshold, Callback &&callback) const {
+                    report(1, 0, leaves_, prefix, threshold, callback);
+                }
+        };
+
+        struct SlabResult
+        {
+            double union_area = 0.0;
+            double overlap_area = 0.0;
+            std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        };
+
+        // Прямоугольники, начавшиеся левее полосы, вставляются на ее левой границе без поиска пар:
+        // пара сообщается только в полосе, где начинается позже начавшийся из двух
+        void sweep_slab(std::span<const Bounds2D> boxes, const std::vector<uint32_t> &members,
+                        double left, double right, bool collect_pairs, SlabResult &result) {
+            if (members.empty()) return;
+            const size_t count = members.size();
+
+            enum Kind : uint8_t { Remove, Carried, Insert };
+            struct Event
+            {
+                double x;
+                Kind kind;
+                uint32_t local;
+            };
+
+            std::vector<double> ys;
+            ys.reserve(2 * count);
+            std::vector<Event> events;
+            events.reserve(2 * count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const Bounds2D &b = boxes[members[i]];
+                ys.push_back(b[1]);
+                ys.push_back(b[3]);
+                events.push_back({std::max(b[0], left), b[0] < left ? Carried : Insert, i});
+                events.push_back({std::min(b[2], right), Remove, i});
+            }
+            std::sort(ys.begin(), ys.end());
+            ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+            // Удаление раньше вставки в той же точке: касание по x пересечением не считается
+            std::sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+                if (a.x != b.x) return a.x < b.x;
+                if (a.kind != b.kind) return a.kind < b.kind;
+                return a.local < b.local;
+            });
+
+            std::vector<uint32_t> low(count), high(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const Bounds2D &b = boxes[members[i]];
+                low[i] = static_cast<uint32_t>(std::lower_bound(ys.begin(), ys.end(), b[1]) - ys.begin());
+                high[i] = static_cast<uint32_t>(std::lower_bound(ys.begin(), ys.end(), b[3]) - ys.begin());
+            }
+
+            std::vector<uint32_t> slot_of, local_of;
+            std::vector<double> slot_low;
+            if (collect_pairs) {
+                local_of.resize(count);
+                for (uint32_t i = 0; i < count; ++i) local_of[i] = i;
+                std::sort(local_of.begin(), local_of.end(), [&](uint32_t a, uint32_t b) {
+                    const double ya = boxes[members[a]][1], yb = boxes[members[b]][1];
+                    return ya < yb || (ya == yb && a < b);
+                });
+                slot_of.resize(count);
+                slot_low.resize(count);
+                for (uint32_t s = 0; s < count; ++s) {
+                    slot_of[local_of[s]] = s;
+                    slot_low[s] = boxes[members[local_of[s]]][1];
+                }
+            }
+
+            CoverageTree coverage(ys);
+            MaxEndTree active(collect_pairs ? count : 1);
+            double previous = events.front().x;
+            for (const Event &event : events) {
+                if (event.x > previous) {
+                    const double dx = event.x - previous;
+                    result.union_area += dx * coverage.covered();
+                    result.overlap_area += dx * coverage.pair_length();
+                    previous = event.x;
+                }
+
+                const uint32_t i = event.local;
+                coverage.add(low[i], high[i], event.kind == Remove ? -1 : 1);
+                if (!collect_pairs) continue;
+
+                const Bounds2D &b = boxes[members[i]];
+                if (event.kind == Remove) {
+                    active.set(slot_of[i], -std::numeric_limits<double>::infinity());
+                    continue;
+                }
+                if (event.kind == Insert) {
+                    // Активные с нижней границей строго ниже b[3] и верхней строго выше b[1]
+                    const size_t prefix = std::lower_bound(slot_low.begin(), slot_low.end(), b[3]) - slot_low.begin();
+                    active.report(prefix, b[1], [&](size_t slot) {
+                        const uint32_t first = members[i], second = members[local_of[slot]];
+                        result.pairs.emplace_back(std::min(first, second), std::max(first, second));
+                    });
+                }
+                active.set(slot_of[i], b[3]);
+            }
+        }
+    }
+
+    CoverageReport analyze_coverage(std::span<const Bounds2D> boxes, bool collect_pairs, StageScheduler* scheduler) {
+        CoverageReport report;
+        if (boxes.size() >= std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Слишком много прямоугольников для анализа покрытия");
+        }
+
+        // Прямоугольники нулевой площади (и с NaN) ни на что не влияют
+        std::vector<uint32_t> valid;
+        valid.reserve(boxes.size());
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i][2] > boxes[i][0] && boxes[i][3] > boxes[i][1]) {
+                valid.push_back(i);
+            }
+        }
+        if (valid.empty()) return report;
+
+        // Границы полос - квантили левых сторон
+        const size_t slab_count = std::clamp<size_t>(valid.size() / slab_size, 1, max_slabs);
+        std::vector<double> starts(valid.size());
+        for (size_t i = 0; i < valid.size(); ++i) starts[i] = boxes[valid[i]][0];
+        std::sort(starts.begin(), starts.end());
+        std::vector<double> edges = {-std::numeric_limits<double>::infinity()};
+        for (size_t s = 1; s < slab_count; ++s) {
+            const double edge = starts[s * starts.size() / slab_count];
+            if (edge > edges.back()) edges.push_back(edge);
+        }
+        edges.push_back(std::numeric_limits<double>::infinity());
+
+        const size_t slabs = edges.size() - 1;
+        std::vector<SlabResult> results(slabs);
+        auto process = [&](size_t s) {
+            const double left = edges[s], right = edges[s + 1];
+            std::vector<uint32_t> members;
+            for (uint32_t id : valid) {
+                if (boxes[id][0] < right && boxes[id][2] > left) members.push_back(id);
+            }
+            sweep_slab(boxes, members, left, right, collect_pairs, results[s]);
+        };
+        if (scheduler && slabs > 1) {
+            scheduler->parallel_for(slabs, process);
+        } else {
+            for (size_t s = 0; s < slabs; ++s) process(s);
+        }
+
+        size_t pair_count = 0;
+        for (const SlabResult& result : results) pair_count += result.pairs.size();
+        report.pairs.reserve(pair_count);
+        for (SlabResult& result : results) {
+            report.union_area += result.union_area;
+            report.overlap_area += result.overlap_area;
+            report.pairs.insert(report.pairs.end(), result.pairs.begin(), result.pairs.end());
+        }
+        return report;
+    }
+
+    double union_area(std::span<const Bounds2D> boxes, StageScheduler* scheduler) {
+        return analyze_coverage(boxes, false, scheduler).union_area;
+    }
+
+    double pairwise_overlap_area(std::span<const Bounds2D> boxes, StageScheduler* scheduler) {
+        return analyze_coverage(boxes, false, scheduler).overlap_area;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> overlapping_pairs(std::span<const Bounds2D> boxes, StageScheduler* scheduler) {
+        return analyze_coverage(boxes, true, scheduler).pairs;
+    }
+
+} // namespace Geometry3D
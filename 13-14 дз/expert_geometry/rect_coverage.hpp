@@ -0,0 +1,36 @@
+#ifndef RECT_COVERAGE_HPP
+#define RECT_COVERAGE_HPP
+
+#include "geometry3d.hpp"
+#include "rect_index.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Geometry3D
+{
+    struct CoverageReport
+    {
+        double union_area = 0.0;
+        // Сумма площадей пересечений по всем парам: область, покрытая k раз, входит k(k-1)/2 раз
+        double overlap_area = 0.0;
+        // Пары (i, j), i < j, с пересечением ненулевой площади; соприкосновение пересечением не считается
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    };
+
+    // Заметание по x с деревом отрезков по сжатым y, O(n log n + k log n) для k пар.
+    // Плоскость режется на вертикальные полосы, число которых зависит только от n,
+    // полосы обрабатываются независимо (параллельно при наличии планировщика),
+    // поэтому результат одинаков при любом числе потоков
+    CoverageReport analyze_coverage(std::span<const Bounds2D> boxes, bool collect_pairs,
+                                    StageScheduler *scheduler = nullptr);
+
+    double union_area(std::span<const Bounds2D> boxes, StageScheduler *scheduler = nullptr);
+    double pairwise_overlap_area(std::span<const Bounds2D> boxes, StageScheduler *scheduler = nullptr);
+    std::vector<std::pair<uint32_t, uint32_t>> overlapping_pairs(std::span<const Bounds2D> boxes,
+                                                                 StageScheduler *scheduler = nullptr);
+
+} // namespace Geometry3D
+
+#endif // RECT_COVERAGE_HPP
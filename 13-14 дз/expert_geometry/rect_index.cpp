@@ -0,0 +1,390 @@
+#include "rect_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace Geometry3D {
+
+    namespace {
+        inline double box_area(const Bounds2D& b) {
+            return (b[2] - b[0]) * (b[3] - b[1]);
+        }
+
+        inline Bounds2D box_union(const Bounds2D& a, const Bounds2D& b) {
+            return {std::min(a[0], b[0]), std::min(a[1], b[1]), std::max(a[2], b[2]), std::max(a[3], b[3])};
+        }
+
+        inline double overlap_area(const Bounds2D& a, const Bounds2D& b) {
+            const double w = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+            const double h = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+            return (w > 0.0 && h > 0.0) ? w * h : 0.0;
+        }
+
+        inline bool box_contains(const Bounds2D& outer, const Bounds2D& inner) {
+            return outer[0] <= inner[0] && outer[1] <= inner[1] && outer[2] >= inner[2] && outer[3] >= inner[3];
+        }
+
+        inline double center(const Bounds2D& b, size_t axis) {
+            return 0.5 * (b[axis] + b[axis + 2]);
+        }
+
+        constexpr Bounds2D empty_box = {
+            std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()
+        };
+    }
+
+    uint32_t RectIndex::allocate_node(uint32_t level) {
+        uint32_t node;
+        if (!free_nodes_.empty()) {
+            node = free_nodes_.back();
+            free_nodes_.pop_back();
+        } else {
+            node = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        nodes_[node].count = 0;
+        nodes_[node].level = level;
+        return node;
+    }
+
+    void RectIndex::release_node(uint32_t node) {
+        nodes_[node].count = 0;
+        free_nodes_.push_back(node);
+    }
+
+    Bounds2D RectIndex::entry_bounds(uint32_t node, size_t i) const {
+        const Node& n = nodes_[node];
+        return {n.min_x[i], n.min_y[i], n.max_x[i], n.max_y[i]};
+    }
+
+    Bounds2D RectIndex::node_bounds(uint32_t node) const {
+        const Node& n = nodes_[node];
+        Bounds2D result = empty_box;
+        for (size_t i = 0; i < n.count; ++i) {
+            result[0] = std::min(result[0], n.min_x[i]);
+            result[1] = std::min(result[1], n.min_y[i]);
+            result[2] = std::max(result[2], n.max_x[i]);
+            result[3] = std::max(result[3], n.max_y[i]);
+        }
+        return result;
+    }
+
+    void RectIndex::set_entry(uint32_t node, size_t i, const Bounds2D& box, uint32_t child) {
+        Node& n = nodes_[node];
+        n.min_x[i] = box[0];
+        n.min_y[i] = box[1];
+        n.max_x[i] = box[2];
+        n.max_y[i] = box[3];
+        n.child[i] = child;
+    }
+
+    uint32_t RectIndex::add_entry(uint32_t node, const Bounds2D& box, uint32_t child) {
+        Node& n = nodes_[node];
+        if (n.count < fanout) {
+            set_entry(node, n.count++, box, child);
+            return npos;
+        }
+        return split_node(node, {box, child});
+    }
+
+    void RectIndex::remove_entry(uint32_t node, size_t i) {
+        const size_t last = nodes_[node].count - 1;
+        if (i != last) {
+            set_entry(node, i, entry_bounds(node, last), nodes_[node].child[last]);
+        }
+        nodes_[node].count = static_cast<uint32_t>(last);
+    }
+
+    // Переполненный узел делится по оси и позиции с наименьшим перекрытием половин,
+    // при равенстве - с наименьшей суммарной площадью
+    uint32_t RectIndex::split_node(uint32_t node, const Entry& extra) {
+        std::array<Entry, fanout + 1> entries;
+        for (size_t i = 0; i < fanout; ++i) {
+            entries[i] = {entry_bounds(node, i), nodes_[node].child[i]};
+        }
+        entries[fanout] = extra;
+        const size_t total = entries.size();
+
+        size_t best_axis = 0, best_split = min_fill;
+        double best_overlap = std::numeric_limits<double>::infinity();
+        double best_area = std::numeric_limits<double>::infinity();
+        std::array<Bounds2D, fanout + 1> prefix, suffix;
+
+        for (size_t axis = 0; axis < 2; ++axis) {
+            std::sort(entries.begin(), entries.end(), [axis](const Entry& a, const Entry& b) {
+                return a.box[axis] < b.box[axis] || (a.box[axis] == b.box[axis] && a.box[axis + 2] < b.box[axis + 2]);
+            });
+            prefix[0] = entries[0].box;
+            for (size_t i = 1; i < total; ++i) prefix[i] = box_union(prefix[i - 1], entries[i].box);
+            suffix[total - 1] = entries[total - 1].box;
+            for (size_t i = total - 1; i-- > 0;) suffix[i] = box_union(suffix[i + 1], entries[i].box);
+
+            for (size_t k = min_fill; k + min_fill <= total; ++k) {
+                const double overlap = overlap_area(prefix[k - 1], suffix[k]);
+                const double area = box_area(prefix[k - 1]) + box_area(suffix[k]);
+                if (overlap < best_overlap || (overlap == best_overlap && area < best_area)) {
+                    best_overlap = overlap;
+                    best_area = area;
+                    best_axis = axis;
+                    best_split = k;
+                }
+            }
+        }
+
+        if (best_axis == 0) {
+            std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+                return a.box[0] < b.box[0] || (a.box[0] == b.box[0] && a.box[2] < b.box[2]);
+            });
+        }
+
+        const uint32_t sibling = allocate_node(nodes_[node].level);
+        nodes_[node].count = 0;
+        for (size_t i = 0; i < total; ++i) {
+            const uint32_t target = i < best_split ? node : sibling;
+            set_entry(target, nodes_[target].count++, entries[i].box, entries[i].child);
+        }
+        return sibling;
+    }
+
+    uint32_t RectIndex::insert_at(uint32_t node, const Bounds2D& box, Id id) {
+        if (nodes_[node].level == 0) {
+            return add_entry(node, box, id);
+        }
+
+        // Поддерево, которое меньше всего расширится; при равенстве - меньшее по площади
+        size_t best = 0;
+        double best_growth = std::numeric_limits<double>::infinity();
+        double best_area = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < nodes_[node].count; ++i) {
+            const Bounds2D current = entry_bounds(node, i);
+            const double area = box_area(current);
+            const double growth = box_area(box_union(current, box)) - area;
+            if (growth < best_growth || (growth == best_growth && area < best_area)) {
+                best_growth = growth;
+                best_area = area;
+                best = i;
+            }
+        }
+
+        const uint32_t child = nodes_[node].child[best];
+        const uint32_t sibling = insert_at(child, box, id);
+        set_entry(node, best, node_bounds(child), child);
+        if (sibling == npos) {
+            return npos;
+        }
+        return add_entry(node, node_bounds(sibling), sibling);
+    }
+
+    bool RectIndex::find_leaf(uint32_t node, const Bounds2D& box, Id id,
+                              std::vector<std::pair<uint32_t, size_t>>& path) const {
+        const Node& n = nodes_[node];
+        for (size_t i = 0; i < n.count; ++i) {
+            const Bounds2D current = entry_bounds(node, i);
+            if (n.level == 0) {
+                if (n.child[i] == id && current == box) {
+                    path.emplace_back(node, i);
+                    return true;
+                }
+            } else if (box_contains(current, box)) {
+                path.emplace_back(node, i);
+                if (find_leaf(n.child[i], box, id, path)) {
+                    return true;
+                }
+                path.pop_back();
+            }
+        }
+        return false;
+    }
+
+    void RectIndex::collect_entries(uint32_t node, std::vector<Entry>& entries) {
+        for (size_t i = 0; i < nodes_[node].count; ++i) {
+            if (nodes_[node].level == 0) {
+                entries.push_back({entry_bounds(node, i), nodes_[node].child[i]});
+            } else {
+                collect_entries(nodes_[node].child[i], entries);
+            }
+        }
+        release_node(node);
+    }
+
+    // Один уровень STR: сортировка по x, нарезка на вертикальные полосы,
+    // сортировка каждой полосы по y и упаковка подряд идущих записей в узлы
+    std::vector<RectIndex::Entry> RectIndex::pack_level(std::vector<Entry> entries, uint32_t level,
+                                                        StageScheduler* scheduler) {
+        const size_t count = entries.size();
+        const size_t node_count = (count + fanout - 1) / fanout;
+        const size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+        const size_t slice_size = fanout * ((node_count + slices - 1) / slices);
+        const size_t slice_count = (count + slice_size - 1) / slice_size;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return center(a.box, 0) < center(b.box, 0);
+        });
+        auto sort_slice = [&](size_t s) {
+            auto begin = entries.begin() + s * slice_size;
+            auto end = entries.begin() + std::min(count, (s + 1) * slice_size);
+            std::sort(begin, end, [](const Entry& a, const Entry& b) {
+                return center(a.box, 1) < center(b.box, 1);
+            });
+        };
+        if (scheduler && slice_count > 1) {
+            scheduler->parallel_for(slice_count, sort_slice);
+        } else {
+            for (size_t s = 0; s < slice_count; ++s) sort_slice(s);
+        }
+
+        std::vector<Entry> parents;
+        parents.reserve(node_count);
+        for (size_t begin = 0; begin < count; begin += fanout) {
+            const uint32_t node = allocate_node(level);
+            const size_t end = std::min(count, begin + fanout);
+            for (size_t i = begin; i < end; ++i) {
+                set_entry(node, i - begin, entries[i].box, entries[i].child);
+            }
+            nodes_[node].count = static_cast<uint32_t>(end - begin);
+            parents.push_back({node_bounds(node), node});
+        }
+        return parents;
+    }
+
+    void RectIndex::build(std::span<const Bounds2D> boxes, StageScheduler* scheduler) {
+        clear();
+        if (boxes.empty()) return;
+        if (boxes.size() >= npos) {
+            throw std::length_error("Слишком много прямоугольников для индекса");
+        }
+
+        std::vector<Entry> entries(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            entries[i] = {boxes[i], static_cast<uint32_t>(i)};
+        }
+        nodes_.reserve(boxes.size() / (fanout - 1) + 1);
+
+        uint32_t level = 0;
+        while (entries.size() > fanout) {
+            entries = pack_level(std::move(entries), level++, scheduler);
+        }
+        root_ = allocate_node(level);
+        for (const Entry& entry : entries) {
+            add_entry(root_, entry.box, entry.child);
+        }
+        size_ = boxes.size();
+    }
+
+    void RectIndex::insert(Id id, const Bounds2D& box) {
+        if (root_ == npos) {
+            root_ = allocate_node(0);
+        }
+        const uint32_t sibling = insert_at(root_, box, id);
+        if (sibling != npos) {
+            const uint32_t old_root = root_;
+            root_ = allocate_node(nodes_[old_root].level + 1);
+            add_entry(root_, node_bounds(old_root), old_root);
+            add_entry(root_, node_bounds(sibling), sibling);
+        }
+        ++size_;
+    }
+
+    bool RectIndex::remove(Id id, const Bounds2D& box) {
+        std::vector<std::pair<uint32_t, size_t>> path;
+        if (root_ == npos || !find_leaf(root_, box, id, path)) {
+            return false;
+        }
+
+        // Недозаполненные узлы на пути убираются целиком, их записи вставляются заново
+        std::vector<Entry> orphans;
+        remove_entry(path.back().first, path.back().second);
+        for (size_t depth = path.size() - 1; depth > 0; --depth) {
+            const uint32_t node = path[depth].first;
+            const auto [parent, slot] = path[depth - 1];
+            if (nodes_[node].count < min_fill) {
+                collect_entries(node, orphans);
+                remove_entry(parent, slot);
+            } else {
+                set_entry(parent, slot, node_bounds(node), node);
+            }
+        }
+
+        if (nodes_[root_].count == 0) {
+            release_node(root_);
+            root_ = npos;
+        }
+        while (root_ != npos && nodes_[root_].level > 0 && nodes_[root_].count == 1) {
+            const uint32_t old_root = root_;
+            root_ = nodes_[old_root].child[0];
+            release_node(old_root);
+        }
+
+        size_ -= 1 + orphans.size();
+        for (const Entry& entry : orphans) {
+            insert(entry.child, entry.box);
+        }
+        return true;
+    }
+
+    void RectIndex::clear() {
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = npos;
+        size_ = 0;
+    }
+
+    void RectIndex::query_window(const Bounds2D& window, std::vector<Id>& out) const {
+        if (root_ == npos) return;
+        std::vector<uint32_t> stack = {root_};
+        while (!stack.empty()) {
+            const Node& n = nodes_[stack.back()];
+            stack.pop_back();
+            for (size_t i = 0; i < n.count; ++i) {
+                if (n.min_x[i] <= window[2] && n.max_x[i] >= window[0] &&
+                    n.min_y[i] <= window[3] && n.max_y[i] >= window[1]) {
+                    if (n.level == 0) {
+                        out.push_back(n.child[i]);
+                    } else {
+                        stack.push_back(n.child[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    void RectIndex::query_point(double x, double y, std::vector<Id>& out) const {
+        query_window({x, y, x, y}, out);
+    }
+
+    // Обход по возрастанию расстояния: очередь хранит и узлы, и записи листьев,
+    // запись, извлеченная из очереди, ближе всего, что еще не просмотрено
+    std::vector<RectIndex::Id> RectIndex::nearest(double x, double y, size_t k) const {
+        struct Candidate
+        {
+            double distance;
+            uint32_t value;
+            bool is_item;
+            bool operator>(const Candidate& other) const { return distance > other.distance; }
+        };
+
+        std::vector<Id> result;
+        if (root_ == npos || k == 0) return result;
+
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+        queue.push({0.0, root_, false});
+        while (!queue.empty() && result.size() < k) {
+            const Candidate top = queue.top();
+            queue.pop();
+            if (top.is_item) {
+                result.push_back(top.value);
+                continue;
+            }
+            const Node& n = nodes_[top.value];
+            for (size_t i = 0; i < n.count; ++i) {
+                const double dx = std::max({n.min_x[i] - x, 0.0, x - n.max_x[i]});
+                const double dy = std::max({n.min_y[i] - y, 0.0, y - n.max_y[i]});
+                queue.push({dx * dx + dy * dy, n.child[i], n.level == 0});
+            }
+        }
+        return result;
+    }
+
+} // namespace Geometry3D
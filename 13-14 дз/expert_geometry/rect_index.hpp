@@ -0,0 +1,100 @@
+#ifndef RECT_INDEX_HPP
+#define RECT_INDEX_HPP
+
+#include "geometry3d.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Geometry3D
+{
+    // Границы прямоугольника: {min_x, min_y, max_x, max_y}, интервалы замкнутые
+    using Bounds2D = std::array<double, 4>;
+
+    // R-дерево над прямоугольниками. Строится пакетно методом STR (Sort-Tile-Recursive),
+    // затем поддерживает вставку и удаление. Идентификатор записи задает вызывающий,
+    // обычно это индекс прямоугольника в его коллекции
+    class RectIndex
+    {
+        public:
+            using Id = uint32_t;
+            static constexpr size_t fanout = 8;
+
+        private:
+            static constexpr size_t min_fill = 3;
+            static constexpr uint32_t npos = UINT32_MAX;
+
+            // Каждая координата хранится отдельным массивом ровно в одну кэш-линию,
+            // поэтому проверка всех записей узла читает четыре линии подряд
+            struct alignas(64) Node
+            {
+                double min_x[fanout];
+                double min_y[fanout];
+                double max_x[fanout];
+                double max_y[fanout];
+                uint32_t child[fanout];     // в листе - Id, во внутреннем узле - номер узла
+                uint32_t count = 0;
+                uint32_t level = 0;         // 0 - лист
+            };
+
+            struct Entry
+            {
+                Bounds2D box;
+                uint32_t child;
+            };
+
+            std::vector<Node> nodes_;
+            std::vector<uint32_t> free_nodes_;
+            uint32_t root_ = npos;
+            size_t size_ = 0;
+
+            uint32_t allocate_node(uint32_t level);
+            void release_node(uint32_t node);
+            Bounds2D entry_bounds(uint32_t node, size_t i) const;
+            Bounds2D node_bounds(uint32_t node) const;
+            void set_entry(uint32_t node, size_t i, const Bounds2D &box, uint32_t child);
+            uint32_t add_entry(uint32_t node, const Bounds2D &box, uint32_t child);
+            void remove_entry(uint32_t node, size_t i);
+            uint32_t split_node(uint32_t node, const Entry &extra);
+            uint32_t insert_at(uint32_t node, const Bounds2D &box, Id id);
+            bool find_leaf(uint32_t node, const Bounds2D &box, Id id, std::vector<std::pair<uint32_t, size_t>> &path) const;
+            void collect_entries(uint32_t node, std::vector<Entry> &entries);
+            std::vector<Entry> pack_level(std::vector<Entry> entries, uint32_t level, StageScheduler *scheduler);
+
+        public:
+            RectIndex() = default;
+
+            // Пакетная загрузка, Id записи - ее позиция в boxes; прежнее содержимое удаляется
+            void build(std::span<const Bounds2D> boxes, StageScheduler *scheduler = nullptr);
+
+            // Любой диапазон фигур с методом bounds(), например std::vector<AdvancedRectangle<...>>
+            template <typename Range>
+            void build_from(const Range &rects, StageScheduler *scheduler = nullptr)
+            {
+                std::vector<Bounds2D> boxes(rects.size());
+                for (size_t i = 0; i < rects.size(); ++i) {
+                    boxes[i] = rects[i].bounds();
+                }
+                build(boxes, scheduler);
+            }
+
+            void insert(Id id, const Bounds2D &box);
+            // box должен совпадать с тем, с которым запись была добавлена
+            bool remove(Id id, const Bounds2D &box);
+            void clear();
+
+            // Результаты дописываются в out
+            void query_window(const Bounds2D &window, std::vector<Id> &out) const;
+            void query_point(double x, double y, std::vector<Id> &out) const;
+            // k ближайших по евклидову расстоянию до прямоугольника (0 для содержащих точку)
+            std::vector<Id> nearest(double x, double y, size_t k = 1) const;
+
+            size_t size() const noexcept { return size_; }
+            bool empty() const noexcept { return size_ == 0; }
+            size_t height() const noexcept { return root_ == npos ? 0 : nodes_[root_].level + 1; }
+    };
+
+} // namespace Geometry3D
+
+#endif // RECT_INDEX_HPP
@@ -598,7 +598,7 @@ void DX12RayTracing::CreateAccelerationStructures()
                         Geometry3D::StrictValidation, 
                         Geometry3D::JSONSerialization>;
     TriangleBox box(vertex1_, vertex2_, vertex3_);
-    auto boundary = box.get_boundary_points(1);
+    const auto& boundary = box.get_render_data().first;
     vertices_.resize(boundary.size());
     for (size_t i = 0; i < boundary.size(); ++i) {
         vertices_[i] = { 
@@ -1464,7 +1464,7 @@ void DX12RayTracing::UpdateGeometry(
     Geometry3D::JSONSerialization>& box
 )
 {
-    auto boundary = box.get_boundary_points(1);
+    const auto& boundary = box.get_render_data().first;
     vertices_.resize(boundary.size());
     for (size_t i = 0; i < boundary.size(); ++i) {
         vertices_[i] = { 
@@ -2,9 +2,47 @@
 #include <iostream>
 #include <cmath>
 
-Barrier::Barrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace {
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+Barrier::Barrier(size_t count) : remaining_(count), phase_(0), count_(count) {
+    // Если потоков больше, чем ядер, ожидание в цикле только отнимает время у остальных
+    size_t hardware = std::thread::hardware_concurrency();
+    spin_limit_ = (hardware != 0 && count <= hardware) ? 4096 : 0;
+}
 
 void Barrier::arrive_and_wait() {
+    const uint32_t phase = phase_.load(std::memory_order_acquire);
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        remaining_.store(count_, std::memory_order_relaxed);
+        phase_.store(phase + 1, std::memory_order_release);
+        phase_.notify_all();
+        return;
+    }
+
+    for (unsigned i = 0; i < spin_limit_; ++i) {
+        if (phase_.load(std::memory_order_acquire) != phase) return;
+        cpu_relax();
+    }
+    while (phase_.load(std::memory_order_acquire) == phase) {
+        phase_.wait(phase, std::memory_order_acquire);
+    }
+}
+
+MutexBarrier::MutexBarrier(size_t count) : count_(count), waiting_(0), generation_(0) {}
+
+void MutexBarrier::arrive_and_wait() {
     std::unique_lock<std::mutex> lock(mtx_);
     size_t gen = generation_;
     ++waiting_;
@@ -32,22 +70,442 @@ namespace Geometry3D {
         return OptionalDouble();
     }
 
-    void StrictValidation::validate(double w, double h) const {
-        if (w <= 0.0 || h <= 0.0) {
-            throw std::invalid_argument("Размеры должны быть положительными");
+    namespace {
+        thread_local std::pmr::memory_resource* current_arena = nullptr;
+    }
+
+    ArenaStorage::Scope::Scope(std::pmr::memory_resource& resource) : previous_(current_arena) {
+        current_arena = &resource;
+    }
+
+    ArenaStorage::Scope::~Scope() {
+        current_arena = previous_;
+    }
+
+    std::pmr::memory_resource* ArenaStorage::resource() noexcept {
+        return current_arena ? current_arena : std::pmr::get_default_resource();
+    }
+
+    namespace {
+        void throw_validation_error(uint8_t errors) {
+            if (errors & NonPositiveSize) {
+                throw std::invalid_argument("Размеры должны быть положительными");
+            }
+            if (errors & SizeTooLarge) {
+                throw std::overflow_error("Размеры слишком большие");
+            }
+            if (errors & NonFiniteValue) {
+                throw std::invalid_argument("Размеры должны быть конечными числами");
+            }
         }
-        if (w > 1e6 || h > 1e6) {
-            throw std::overflow_error("Размеры слишком большие");
+    }
+
+    void StrictValidation::validate(double w, double h) const {
+        if (uint8_t errors = check(w, h)) {
+            throw_validation_error(errors);
         }
     }
 
     void StrictValidation::validate(double w, double h, double d) const {
-        if (w <= 0.0 || h <= 0.0 || d <= 0.0) {
-            throw std::invalid_argument("Размеры должны быть положительными");
+        if (uint8_t errors = check(w, h, d)) {
+            throw_validation_error(errors);
         }
-        if (w > 1e6 || h > 1e6 || d > 1e6) {
-            throw std::overflow_error("Размеры слишком большие");
+    }
+
+    void StrictValidation::validate(const Point<double, 3>& a, const Point<double, 3>& b, const Point<double, 3>& c) const {
+        if (is_degenerate_triangle(a, b, c)) {
+            throw std::invalid_argument("Вершины треугольника лежат на одной прямой");
+        }
+    }
+
+    size_t StrictValidation::validate_batch(std::span<const double> widths, std::span<const double> heights,
+                                            std::span<uint8_t> errors) {
+        if (widths.size() != heights.size() || errors.size() != widths.size()) {
+            throw std::invalid_argument("Размеры массивов для проверки не совпадают");
+        }
+        size_t invalid = 0;
+        for (size_t i = 0; i < widths.size(); ++i) {
+            const uint8_t mask = check(widths[i], heights[i]);
+            errors[i] = mask;
+            invalid += mask != 0;
+        }
+        return invalid;
+    }
+
+    size_t StrictValidation::validate_triangles(std::span<const Point<double, 3>> vertices,
+                                                std::span<const size_t> indices, std::span<uint8_t> errors) {
+        const size_t triangles = indices.size() / 3;
+        if (indices.size() % 3 != 0 || errors.size() != triangles) {
+            throw std::invalid_argument("Размеры массивов для проверки не совпадают");
+        }
+        const double limit = std::numeric_limits<double>::max();
+        size_t invalid = 0;
+        for (size_t t = 0; t < triangles; ++t) {
+            const size_t* corner = &indices[3 * t];
+            uint8_t mask = ValidationOk;
+            if (corner[0] >= vertices.size() || corner[1] >= vertices.size() || corner[2] >= vertices.size()) {
+                mask = IndexOutOfRange;
+            } else {
+                const Point<double, 3>& a = vertices[corner[0]];
+                const Point<double, 3>& b = vertices[corner[1]];
+                const Point<double, 3>& c = vertices[corner[2]];
+                bool finite = true;
+                for (size_t k = 0; k < 3; ++k) {
+                    finite &= std::fabs(a[k]) <= limit && std::fabs(b[k]) <= limit && std::fabs(c[k]) <= limit;
+                }
+                if (!finite) {
+                    mask = NonFiniteValue;
+                } else if (is_degenerate_triangle(a, b, c)) {
+                    mask = DegenerateTriangle;
+                }
+            }
+            errors[t] = mask;
+            invalid += mask != 0;
+        }
+        return invalid;
+    }
+
+
+    StageScheduler::StageScheduler(size_t worker_count) {
+        if (worker_count == 0) {
+            size_t hardware = std::thread::hardware_concurrency();
+            worker_count = hardware > 1 ? hardware - 1 : 1;
+        }
+        ensure_workers(worker_count);
+    }
+
+    StageScheduler::~StageScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    void StageScheduler::ensure_workers(size_t count) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        while (workers_.size() < count) {
+            workers_.emplace_back(&StageScheduler::worker_loop, this, generation_);
+        }
+    }
+
+    void StageScheduler::worker_loop(size_t seen) {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                work_cv_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+                job = job_;
+            }
+            if (job) {
+                run_job(*job);
+            }
+        }
+    }
+
+    void StageScheduler::run_job(Job& job) {
+        for (;;) {
+            size_t begin = job.next.fetch_add(job.grain, std::memory_order_relaxed);
+            if (begin >= job.count) return;
+            size_t end = std::min(begin + job.grain, job.count);
+
+            try {
+                (*job.body)(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!job.error) job.error = std::current_exception();
+            }
+
+            if (job.done.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == job.count) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                done_cv_.notify_all();
+            }
+            if (job.one_per_thread) return;
+        }
+    }
+
+    void StageScheduler::dispatch(const RangeBody& body, size_t count, size_t grain, bool one_per_thread) {
+        if (count == 0) return;
+
+        auto job = std::make_shared<Job>();
+        job->body = &body;
+        job->count = count;
+        job->grain = grain;
+        job->one_per_thread = one_per_thread;
+        bool published = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!job_) {
+                job_ = job;
+                ++generation_;
+                published = true;
+            }
         }
+
+        if (published) {
+            work_cv_.notify_all();
+            run_job(*job);
+
+            std::unique_lock<std::mutex> lock(mtx_);
+            done_cv_.wait(lock, [&job] { return job->done.load(std::memory_order_acquire) == job->count; });
+            job_.reset();
+        } else {
+            // Пул занят другим заданием (вызов из задачи или из другого потока): обычное задание
+            // вызывающий поток выполняет сам, а задачам с барьером даются временные потоки
+            std::vector<std::thread> helpers;
+            if (one_per_thread) {
+                for (size_t i = 1; i < count; ++i) {
+                    helpers.emplace_back([this, job] { run_job(*job); });
+                }
+            }
+            run_job(*job);
+            for (auto& helper : helpers) {
+                helper.join();
+            }
+        }
+
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+    void StageScheduler::run_concurrently(size_t count, const std::function<void(size_t)>& body) {
+        if (count > 1) {
+            ensure_workers(count - 1);
+        }
+        RangeBody range = [&body](size_t begin, size_t) { body(begin); };
+        dispatch(range, count, 1, true);
+    }
+
+    size_t StageScheduler::add_stage(std::string name, size_t task_count, std::function<void(size_t)> body,
+                                     std::vector<size_t> dependencies) {
+        for (size_t dep : dependencies) {
+            if (dep >= stages_.size()) {
+                throw std::out_of_range("Зависимость на несуществующий этап");
+            }
+        }
+        stages_.push_back({std::move(name), task_count, std::move(body), std::move(dependencies)});
+        return stages_.size() - 1;
+    }
+
+    void StageScheduler::clear_stages() {
+        stages_.clear();
+    }
+
+    std::vector<StageTiming> StageScheduler::run() {
+        using Clock = std::chrono::steady_clock;
+
+        // Этапы одного уровня не зависят друг от друга и выполняются одним parallel_for
+        std::vector<size_t> level(stages_.size(), 0);
+        size_t level_count = 0;
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            for (size_t dep : stages_[s].dependencies) {
+                level[s] = std::max(level[s], level[dep] + 1);
+            }
+            level_count = std::max(level_count, level[s] + 1);
+        }
+
+        std::vector<Clock::time_point> start(stages_.size());
+        std::vector<Clock::time_point> finish(stages_.size());
+        std::unique_ptr<std::atomic<size_t>[]> remaining(new std::atomic<size_t>[stages_.size()]);
+        std::unique_ptr<std::atomic<bool>[]> started(new std::atomic<bool>[stages_.size()]);
+
+        for (size_t current = 0; current < level_count; ++current) {
+            std::vector<size_t> wave;
+            std::vector<size_t> offsets{0};
+            for (size_t s = 0; s < stages_.size(); ++s) {
+                if (level[s] != current) continue;
+                wave.push_back(s);
+                offsets.push_back(offsets.back() + stages_[s].task_count);
+                remaining[s].store(stages_[s].task_count, std::memory_order_relaxed);
+                started[s].store(false, std::memory_order_relaxed);
+                start[s] = finish[s] = Clock::now();
+            }
+
+            RangeBody range = [&](size_t begin, size_t end) {
+                size_t w = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+                while (begin < end) {
+                    const size_t s = wave[w];
+                    const size_t stop = std::min(end, offsets[w + 1]);
+                    if (!started[s].exchange(true, std::memory_order_relaxed)) {
+                        start[s] = Clock::now();
+                    }
+                    for (size_t i = begin; i < stop; ++i) {
+                        stages_[s].body(i - offsets[w]);
+                    }
+                    if (remaining[s].fetch_sub(stop - begin, std::memory_order_acq_rel) == stop - begin) {
+                        finish[s] = Clock::now();
+                    }
+                    begin = stop;
+                    ++w;
+                }
+            };
+
+            const size_t total = offsets.back();
+            const size_t grain = std::max<size_t>(1, total / ((workers_.size() + 1) * 8));
+            dispatch(range, total, grain, false);
+        }
+
+        std::vector<StageTiming> timings;
+        timings.reserve(stages_.size());
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            timings.push_back({stages_[s].name, stages_[s].task_count,
+                               std::chrono::duration<double, std::milli>(finish[s] - start[s]).count()});
+        }
+        return timings;
+    }
+
+    bool is_closed_mesh(std::span<const size_t> indices) {
+        if (indices.empty()) return false;
+
+        std::vector<std::pair<size_t, size_t>> edges;
+        edges.reserve(indices.size());
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            for (size_t e = 0; e < 3; ++e) {
+                edges.emplace_back(indices[t + e], indices[t + (e + 1) % 3]);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (i + 1 < edges.size() && edges[i] == edges[i + 1]) return false;
+            const std::pair<size_t, size_t> twin(edges[i].second, edges[i].first);
+            if (!std::binary_search(edges.begin(), edges.end(), twin)) return false;
+        }
+        return true;
+    }
+
+    namespace {
+        // Суммирование Ноймайера
+        struct CompensatedSum
+        {
+            double sum = 0.0;
+            double error = 0.0;
+
+            void add(double value) {
+                double total = sum + value;
+                if (std::fabs(sum) >= std::fabs(value)) {
+                    error += (sum - total) + value;
+                } else {
+                    error += (value - total) + sum;
+                }
+                sum = total;
+            }
+
+            void add(const CompensatedSum& other) {
+                add(other.sum);
+                add(other.error);
+            }
+
+            double value() const { return sum + error; }
+        };
+
+        // Объем, первый момент (3) и второй момент (6 компонент симметричной матрицы)
+        struct MomentSums
+        {
+            CompensatedSum terms[10];
+
+            void add(const MomentSums& other) {
+                for (size_t k = 0; k < 10; ++k) terms[k].add(other.terms[k]);
+            }
+        };
+
+        void accumulate_moments(std::span<const Point<double, 3>> vertices, std::span<const size_t> indices,
+                                const Point<double, 3>& origin, size_t first, size_t last, MomentSums& out) {
+            for (size_t t = first; t < last; ++t) {
+                double a[3], b[3], c[3];
+                for (size_t k = 0; k < 3; ++k) {
+                    a[k] = vertices[indices[3 * t]][k] - origin[k];
+                    b[k] = vertices[indices[3 * t + 1]][k] - origin[k];
+                    c[k] = vertices[indices[3 * t + 2]][k] - origin[k];
+                }
+                const double det = a[0] * (b[1] * c[2] - b[2] * c[1])
+                                 - a[1] * (b[0] * c[2] - b[2] * c[0])
+                                 + a[2] * (b[0] * c[1] - b[1] * c[0]);
+                const double s[3] = {a[0] + b[0] + c[0], a[1] + b[1] + c[1], a[2] + b[2] + c[2]};
+
+                out.terms[0].add(det / 6.0);
+                for (size_t k = 0; k < 3; ++k) {
+                    out.terms[1 + k].add(det / 24.0 * s[k]);
+                }
+                // Интеграл x_i x_j по тетраэдру: det/120 * (a_i a_j + b_i b_j + c_i c_j + s_i s_j)
+                const size_t rows[6] = {0, 1, 2, 0, 0, 1};
+                const size_t cols[6] = {0, 1, 2, 1, 2, 2};
+                for (size_t k = 0; k < 6; ++k) {
+                    const size_t i = rows[k], j = cols[k];
+                    out.terms[4 + k].add(det / 120.0 * (a[i] * a[j] + b[i] * b[j] + c[i] * c[j] + s[i] * s[j]));
+                }
+            }
+        }
+    }
+
+    MassProperties compute_mass_properties(std::span<const Point<double, 3>> vertices,
+                                           std::span<const size_t> indices,
+                                           StageScheduler* scheduler) {
+        MassProperties result;
+        const size_t triangles = indices.size() / 3;
+        if (triangles == 0) return result;
+
+        // Опорная точка рядом с сеткой уменьшает потерю точности на удаленных координатах
+        const Point<double, 3> origin = vertices[indices[0]];
+
+        const size_t block = 8192;
+        const size_t blocks = (triangles + block - 1) / block;
+        std::vector<MomentSums> partial(blocks);
+        auto run_block = [&](size_t b) {
+            accumulate_moments(vertices, indices, origin, b * block, std::min(triangles, (b + 1) * block), partial[b]);
+        };
+        if (scheduler && blocks > 1) {
+            scheduler->parallel_for(blocks, run_block);
+        } else {
+            for (size_t b = 0; b < blocks; ++b) run_block(b);
+        }
+
+        MomentSums total;
+        for (const auto& part : partial) total.add(part);
+
+        double moments[10];
+        for (size_t k = 0; k < 10; ++k) moments[k] = total.terms[k].value();
+        // Сетка с нормалями внутрь дает отрицательный объем; меняем знак всех моментов
+        if (moments[0] < 0.0) {
+            for (double& m : moments) m = -m;
+        }
+
+        const double volume = moments[0];
+        result.volume = volume;
+        if (volume == 0.0) return result;
+
+        double center[3];
+        for (size_t k = 0; k < 3; ++k) {
+            center[k] = moments[1 + k] / volume;
+            result.center_of_mass[k] = center[k] + origin[k];
+        }
+
+        // Второй момент относительно центра масс, затем тензор инерции I = tr(C) E - C
+        double covariance[3][3];
+        const size_t rows[6] = {0, 1, 2, 0, 0, 1};
+        const size_t cols[6] = {0, 1, 2, 1, 2, 2};
+        for (size_t k = 0; k < 6; ++k) {
+            const size_t i = rows[k], j = cols[k];
+            covariance[i][j] = covariance[j][i] = moments[4 + k] - volume * center[i] * center[j];
+        }
+        const double trace = covariance[0][0] + covariance[1][1] + covariance[2][2];
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                result.inertia[i][j] = (i == j ? trace : 0.0) - covariance[i][j];
+            }
+        }
+        return result;
+    }
+
+    StageScheduler& shared_scheduler() {
+        static StageScheduler scheduler;
+        return scheduler;
     }
 
 } // namespace Geometry3D
\ No newline at end of file
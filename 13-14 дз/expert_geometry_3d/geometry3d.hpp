@@ -2,12 +2,18 @@
 #define GEOMETRY3D_HPP
 
 #include <condition_variable>
+#include <memory_resource>
+#include <initializer_list>
 #include <type_traits>
 #include <filesystem>
+#include <functional>
+#include <exception>
 #include <algorithm>
 #include <iostream> 
 #include <sstream>
 #include <numeric>
+#include <cstdint>
+#include <limits>
 #include <fstream>
 #include <memory>
 #include <vector>
@@ -16,13 +22,36 @@
 #include <thread>
 #include <future>
 #include <atomic>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <variant>
 #include <mutex>
 #include <array>
+#include <span>
 #include <cmath>
 #include <any>
 
+#include "predicates.hpp"
+
+// Барьер со сменой фазы: прибывший поток крутится недолго, затем засыпает на atomic::wait
 class Barrier
+{
+    static constexpr size_t cache_line = 64;
+
+    alignas(cache_line) std::atomic<size_t> remaining_;
+    alignas(cache_line) std::atomic<uint32_t> phase_;
+    alignas(cache_line) size_t count_;
+    unsigned spin_limit_;
+
+    public:
+        explicit Barrier(size_t count);
+        void arrive_and_wait();
+};
+
+// Прежний барьер на мьютексе и condition_variable, оставлен для сравнения
+class MutexBarrier
 {
     std::mutex mtx_;
     std::condition_variable cv_;
@@ -31,7 +60,7 @@ class Barrier
     size_t generation_;
 
     public:
-        explicit Barrier(size_t count);
+        explicit MutexBarrier(size_t count);
         void arrive_and_wait();
 };
 
@@ -96,6 +125,63 @@ namespace Geometry3D
             }
     };
 
+    class StageScheduler;
+
+    struct MassProperties
+    {
+        double volume = 0.0;
+        std::array<double, 3> center_of_mass{};
+        std::array<std::array<double, 3>, 3> inertia{};   // относительно центра масс, плотность 1
+    };
+
+    // Каждое ребро встречается ровно дважды и в противоположных направлениях
+    bool is_closed_mesh(std::span<const size_t> indices);
+
+    // Сумма по тетраэдрам (опорная точка, треугольник); блоки фиксированного размера
+    // складываются по порядку с компенсацией, поэтому результат не зависит от числа потоков
+    MassProperties compute_mass_properties(std::span<const Point<double, 3>> vertices,
+                                           std::span<const size_t> indices,
+                                           StageScheduler *scheduler = nullptr);
+
+    StageScheduler &shared_scheduler();
+
+    struct BoundaryPoints3D
+    {
+        std::vector<double> x, y, z;
+
+        void resize(size_t count) {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+        }
+
+        size_t size() const noexcept { return x.size(); }
+    };
+
+    // Пишет текст в буфер вызывающего без выделения памяти; не поместившееся отбрасывается
+    class ShapeTextWriter
+    {
+        char *begin_;
+        char *pos_;
+        char *end_;
+
+        public:
+            ShapeTextWriter(char *buffer, size_t size) : begin_(buffer), pos_(buffer), end_(buffer + size) {}
+
+            void write(std::string_view text) {
+                const size_t count = std::min(text.size(), static_cast<size_t>(end_ - pos_));
+                pos_ = std::copy_n(text.data(), count, pos_);
+            }
+
+            // Шесть значащих цифр, как у operator<< с настройками потока по умолчанию
+            void write(double value) {
+                auto result = std::to_chars(pos_, end_, value, std::chars_format::general, 6);
+                if (result.ec == std::errc()) pos_ = result.ptr;
+            }
+
+            size_t size() const noexcept { return static_cast<size_t>(pos_ - begin_); }
+    };
+
     template <typename Derived>
     class ShapeCRTP
     {
@@ -287,48 +373,39 @@ namespace Geometry3D
                 return result;
             }
 
-            struct ShapeVariant
-            {
-
-                enum Type { 
-                    Rectangle, 
-                    Number, 
-                    Str 
-                };
-
-                Type type;
-                AdvancedRectangle rect;
-                double num;
-                std::string str;
-
-                ShapeVariant(const AdvancedRectangle& r) : type(Rectangle), rect(r) 
-                {
-
-                }
-                ShapeVariant(double n) : type(Number), num(n) 
-                {
+            // Хранится только одна альтернатива: размер - наибольшая из них плюс тег
+            using ShapeVariant = std::variant<AdvancedRectangle, double, std::string>;
 
-                }
-                ShapeVariant(const std::string& s) : type(Str), str(s) 
-                {
-
-                }
+            template <typename Visitor>
+            static decltype(auto) visit_shape(const ShapeVariant &shape, Visitor &&visitor) {
+                return std::visit(std::forward<Visitor>(visitor), shape);
+            }
 
-            };
+            // Описание фигуры в буфер вызывающего, возвращает число записанных байт
+            static size_t describe_shape(const ShapeVariant &shape, char *buffer, size_t size) {
+                ShapeTextWriter out(buffer, size);
+                visit_shape(shape, [&out](const auto &value) {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, AdvancedRectangle>) {
+                        out.write("Прямоугольник с площадью: ");
+                        out.write(value.area_impl());
+                    } else if constexpr (std::is_same_v<T, double>) {
+                        out.write("Число: ");
+                        out.write(value);
+                    } else {
+                        out.write("Строка: ");
+                        out.write(value);
+                    }
+                });
+                return out.size();
+            }
 
             static std::string match_shape(const ShapeVariant &shape) {
-                std::ostringstream oss;
-                switch (shape.type) {
-                    case ShapeVariant::Rectangle:
-                        oss << "Прямоугольник с площадью: " << shape.rect.area_impl();
-                        return oss.str();
-                    case ShapeVariant::Number:
-                        oss << "Число: " << shape.num;
-                        return oss.str();
-                    case ShapeVariant::Str:
-                        return "Строка: " + shape.str;
+                if (const std::string *str = std::get_if<std::string>(&shape)) {
+                    return "Строка: " + *str;
                 }
-                return "";
+                char buffer[96];
+                return std::string(buffer, describe_shape(shape, buffer, sizeof(buffer)));
             }
 
         private:
@@ -344,29 +421,68 @@ namespace Geometry3D
         private SerializationPolicy
     {
         using PointType = Point<double, 3>;
-        std::vector<PointType> vertices_;
-        std::vector<size_t> indices_;
+        template <typename T>
+        using Buffer = typename StoragePolicy::template buffer<T>;
+
+        Buffer<PointType> vertices_;
+        Buffer<size_t> indices_;
+        bool closed_ = false;
+        MassProperties mass_;       // пересчитывается при задании и изменении вершин, у открытой сетки - нули
         mutable std::atomic<int> access_count_{0};
 
+        // Вызывается при каждом изменении вершин, чтобы кэш не отставал от сетки
+        void update_mass_properties() {
+            if (closed_) {
+                mass_ = compute_mass_properties(vertices_, indices_, &shared_scheduler());
+            }
+        }
+
+        template <typename T, typename Range>
+        static Buffer<T> make_buffer(const Range &items) {
+            Buffer<T> buffer = StoragePolicy::template make_buffer<T>();
+            buffer.assign(items.begin(), items.end());
+            return buffer;
+        }
+
         public:
             using value_type = double;
             using point_type = PointType;
 
-            AdvancedBox() : vertices_{{0,0,0}, {1,0,0}, {0,1,0}}, indices_{0,1,2} {
+            AdvancedBox() :
+                vertices_(make_buffer<PointType>(std::initializer_list<PointType>{{0,0,0}, {1,0,0}, {0,1,0}})),
+                indices_(make_buffer<size_t>(std::initializer_list<size_t>{0,1,2})) {
                 std::cout << "LOG: AdvancedBox default constructor called" << std::endl;
             }
             
-            AdvancedBox(const PointType& v1, const PointType& v2, const PointType& v3): vertices_{v1, v2, v3}, indices_{0,1,2} 
+            AdvancedBox(const PointType& v1, const PointType& v2, const PointType& v3):
+                vertices_(make_buffer<PointType>(std::initializer_list<PointType>{v1, v2, v3})),
+                indices_(make_buffer<size_t>(std::initializer_list<size_t>{0,1,2}))
             {
+                this->validate(v1, v2, v3);
+            }
 
+            AdvancedBox(std::vector<PointType> vertices, std::vector<size_t> indices)
+                : vertices_(StoragePolicy::adopt(std::move(vertices))), indices_(StoragePolicy::adopt(std::move(indices)))
+            {
+                if (indices_.size() % 3 != 0) {
+                    throw std::invalid_argument("Количество индексов должно быть кратно трем");
+                }
+                for (size_t index : indices_) {
+                    if (index >= vertices_.size()) {
+                        throw std::out_of_range("Индекс вершины вне диапазона");
+                    }
+                }
+                closed_ = is_closed_mesh(indices_);
+                update_mass_properties();
             }
 
-            AdvancedBox(AdvancedBox &&other) noexcept: vertices_(std::move(other.vertices_)), indices_(std::move(other.indices_)) 
+            AdvancedBox(AdvancedBox &&other) noexcept: vertices_(std::move(other.vertices_)), indices_(std::move(other.indices_)), closed_(other.closed_), mass_(other.mass_) 
             {
 
             }
 
-            AdvancedBox(const AdvancedBox &other): vertices_(other.vertices_), indices_(other.indices_) 
+            AdvancedBox(const AdvancedBox &other):
+                vertices_(make_buffer<PointType>(other.vertices_)), indices_(make_buffer<size_t>(other.indices_)), closed_(other.closed_), mass_(other.mass_) 
             {
 
             }
@@ -375,12 +491,23 @@ namespace Geometry3D
                 if (this != &other) {
                     vertices_ = other.vertices_;
                     indices_ = other.indices_;
+                    closed_ = other.closed_;
+                    mass_ = other.mass_;
                 }
                 return *this;
             }
 
+            // Объем определен только для замкнутой сетки, у открытой он равен нулю
             double volume_impl() const {
-                return 0.0;
+                return mass_.volume;
+            }
+
+            bool is_closed() const noexcept {
+                return closed_;
+            }
+
+            const MassProperties& mass_properties() const noexcept {
+                return mass_;
             }
 
             double surface_area_impl() const {
@@ -407,31 +534,119 @@ namespace Geometry3D
 
             OptionalDouble safe_divide(double numerator) const {
                 double area = surface_area_impl();
-                if (std::fabs(area) < 1e-10) {
+                if (area == 0.0 || is_degenerate_triangle(vertices_[0], vertices_[1], vertices_[2])) {
                     return OptionalDouble();
                 }
                 return OptionalDouble(numerator / area);
             }
             
             std::vector<PointType> generate_points(double /*step*/ = 1.0) const {
-                return vertices_;
+                return std::vector<PointType>(vertices_.begin(), vertices_.end());
             }
             
+            // Ребра, принадлежащие ровно одному треугольнику, в порядке обхода граней
+            std::vector<std::pair<size_t, size_t>> boundary_edges() const {
+                std::vector<std::pair<size_t, size_t>> directed;
+                directed.reserve(indices_.size());
+                for (size_t t = 0; t + 2 < indices_.size(); t += 3) {
+                    for (size_t e = 0; e < 3; ++e) {
+                        directed.emplace_back(indices_[t + e], indices_[t + (e + 1) % 3]);
+                    }
+                }
+
+                auto key = [](const std::pair<size_t, size_t>& e) {
+                    return std::make_pair(std::min(e.first, e.second), std::max(e.first, e.second));
+                };
+                std::vector<std::pair<size_t, size_t>> sorted(directed.size());
+                std::transform(directed.begin(), directed.end(), sorted.begin(), key);
+                std::sort(sorted.begin(), sorted.end());
+
+                std::vector<std::pair<size_t, size_t>> result;
+                for (const auto& e : directed) {
+                    auto range = std::equal_range(sorted.begin(), sorted.end(), key(e));
+                    if (range.second - range.first == 1) {
+                        result.push_back(e);
+                    }
+                }
+                return result;
+            }
+
+            // segments точек на каждое ребро из edges, начиная с его первой вершины
+            void fill_edge_points(const std::vector<std::pair<size_t, size_t>>& edges, size_t segments,
+                                  double* xs, double* ys, double* zs) const {
+                segments = std::max<size_t>(segments, 1);
+                const double step = 1.0 / static_cast<double>(segments);
+                for (const auto& edge : edges) {
+                    const PointType& a = vertices_[edge.first];
+                    const PointType& b = vertices_[edge.second];
+                    const double dx = b[0] - a[0], dy = b[1] - a[1], dz = b[2] - a[2];
+                    for (size_t k = 0; k < segments; ++k) {
+                        const double t = static_cast<double>(k) * step;
+                        xs[k] = a[0] + dx * t;
+                        ys[k] = a[1] + dy * t;
+                        zs[k] = a[2] + dz * t;
+                    }
+                    xs += segments;
+                    ys += segments;
+                    zs += segments;
+                }
+            }
+
+            // Точки на открытых ребрах сетки; у замкнутой сетки их нет
+            BoundaryPoints3D get_boundary_edge_points(size_t segments) const {
+                const auto edges = boundary_edges();
+                BoundaryPoints3D result;
+                result.resize(edges.size() * std::max<size_t>(segments, 1));
+                fill_edge_points(edges, segments, result.x.data(), result.y.data(), result.z.data());
+                return result;
+            }
+
+            // Вершины фигуры, для треугольника - его углы
             std::vector<PointType> get_boundary_points(size_t /*segments*/) const {
-                std::cout << "Getting boundary points" << std::endl;
-                return vertices_;
+                return std::vector<PointType>(vertices_.begin(), vertices_.end());
             }
 
-            const std::vector<size_t>& get_indices() const {
+            // Точки открытых ребер всех фигур подряд; offsets[i] - начало точек фигуры i,
+            // offsets.back() - общее число. Ребра каждой фигуры ищутся один раз
+            static BoundaryPoints3D generate_boundary_edge_points(const std::vector<AdvancedBox>& shapes, size_t segments,
+                                                                  std::vector<size_t>* offsets = nullptr) {
+                std::vector<std::vector<std::pair<size_t, size_t>>> edges(shapes.size());
+                std::vector<size_t> starts(shapes.size() + 1, 0);
+                for (size_t i = 0; i < shapes.size(); ++i) {
+                    edges[i] = shapes[i].boundary_edges();
+                    starts[i + 1] = starts[i] + edges[i].size() * std::max<size_t>(segments, 1);
+                }
+
+                BoundaryPoints3D result;
+                result.resize(starts.back());
+                for (size_t i = 0; i < shapes.size(); ++i) {
+                    shapes[i].fill_edge_points(edges[i], segments, result.x.data() + starts[i],
+                                               result.y.data() + starts[i], result.z.data() + starts[i]);
+                }
+                if (offsets) {
+                    *offsets = std::move(starts);
+                }
+                return result;
+            }
+
+            const Buffer<size_t>& get_indices() const {
                 return indices_;
             }
 
-            std::pair<const std::vector<PointType>&, const std::vector<size_t>&> get_render_data() const {
+            const Buffer<PointType>& get_vertices() const {
+                return vertices_;
+            }
+
+            size_t triangle_count() const noexcept {
+                return indices_.size() / 3;
+            }
+
+            std::pair<const Buffer<PointType>&, const Buffer<size_t>&> get_render_data() const {
                 return {vertices_, indices_};
             }
 
-            double parallel_volume() const {
-                return volume_impl();
+            double parallel_volume() const noexcept {
+                return mass_.volume;
             }
             
             template <typename Visitor>
@@ -460,6 +675,7 @@ namespace Geometry3D
                     v[1] = centroid[1] + (v[1] - centroid[1]) * factor;
                     v[2] = centroid[2] + (v[2] - centroid[2]) * factor;
                 }
+                update_mass_properties();
             }
 
             void rotate_x(double angle) {
@@ -472,6 +688,7 @@ namespace Geometry3D
                     v[1] = centroid[1] + dy * cos_a - dz * sin_a;
                     v[2] = centroid[2] + dy * sin_a + dz * cos_a;
                 }
+                update_mass_properties();
             }
 
             void rotate_y(double angle) {
@@ -484,6 +701,7 @@ namespace Geometry3D
                     v[0] = centroid[0] + dx * cos_a - dz * sin_a;
                     v[2] = centroid[2] + dx * sin_a + dz * cos_a;
                 }
+                update_mass_properties();
             }
 
             void rotate_z(double angle) {
@@ -496,6 +714,7 @@ namespace Geometry3D
                     v[0] = centroid[0] + dx * cos_a - dy * sin_a;
                     v[1] = centroid[1] + dx * sin_a + dy * cos_a;
                 }
+                update_mass_properties();
             }
 
             Point<double, 2> project_2d() const {
@@ -505,48 +724,39 @@ namespace Geometry3D
                 return Point<double, 2>(x_2d, y_2d);
             }
 
-            struct ShapeVariant3D
-            {
-                enum Type { 
-                    Triangle, 
-                    Number, 
-                    Str 
-                };
-
-                Type type;
-                AdvancedBox triangle;
-                double num;
-                std::string str;
-
-                ShapeVariant3D(const AdvancedBox& t) : type(Triangle), triangle(t) 
-                {
-
-                }
-
-                ShapeVariant3D(double n) : type(Number), num(n) 
-                {
-
-                }
+            // Хранится только одна альтернатива: размер - наибольшая из них плюс тег
+            using ShapeVariant3D = std::variant<AdvancedBox, double, std::string>;
 
-                ShapeVariant3D(const std::string& s) : type(Str), str(s) 
-                {
+            template <typename Visitor>
+            static decltype(auto) visit_shape(const ShapeVariant3D &shape, Visitor &&visitor) {
+                return std::visit(std::forward<Visitor>(visitor), shape);
+            }
 
-                }
-            };
+            // Описание фигуры в буфер вызывающего, возвращает число записанных байт
+            static size_t describe_shape(const ShapeVariant3D &shape, char *buffer, size_t size) {
+                ShapeTextWriter out(buffer, size);
+                visit_shape(shape, [&out](const auto &value) {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, AdvancedBox>) {
+                        out.write("Треугольник с площадью: ");
+                        out.write(value.surface_area_impl());
+                    } else if constexpr (std::is_same_v<T, double>) {
+                        out.write("Число: ");
+                        out.write(value);
+                    } else {
+                        out.write("Строка: ");
+                        out.write(value);
+                    }
+                });
+                return out.size();
+            }
 
             static std::string match_shape_3d(const ShapeVariant3D &shape) {
-                std::ostringstream oss;
-                switch (shape.type) {
-                    case ShapeVariant3D::Triangle:
-                        oss << "Треугольник с площадью: " << shape.triangle.surface_area_impl();
-                        return oss.str();
-                    case ShapeVariant3D::Number:
-                        oss << "Число: " << shape.num;
-                        return oss.str();
-                    case ShapeVariant3D::Str:
-                        return "Строка: " + shape.str;
+                if (const std::string *str = std::get_if<std::string>(&shape)) {
+                    return "Строка: " + *str;
                 }
-                return "";
+                char buffer[96];
+                return std::string(buffer, describe_shape(shape, buffer, sizeof(buffer)));
             }
 
         private:
@@ -555,17 +765,174 @@ namespace Geometry3D
             friend struct JSONSerialization;
     };
 
+    // Политика хранения задает контейнер для вершин и индексов фигуры:
+    // buffer<T>, make_buffer<T>() для пустого контейнера и adopt() для готового std::vector
     struct HeapStorage
     {
+        template <typename T>
+        using buffer = std::vector<T>;
+
+        template <typename T>
+        static buffer<T> make_buffer() { return buffer<T>(); }
+
+        template <typename T>
+        static buffer<T> adopt(std::vector<T> &&items) { return std::move(items); }
+
         std::unique_ptr<double[]> cache_;
         void cache_result(double value);
         OptionalDouble get_cached() const;
     };
 
+    // Фигуры, созданные внутри ArenaStorage::Scope, берут память из привязанного к потоку
+    // ресурса (обычно monotonic_buffer_resource) и не должны пережить этот ресурс
+    struct ArenaStorage
+    {
+        template <typename T>
+        using buffer = std::pmr::vector<T>;
+
+        class Scope
+        {
+            std::pmr::memory_resource *previous_;
+
+            public:
+                explicit Scope(std::pmr::memory_resource &resource);
+                ~Scope();
+
+                Scope(const Scope &) = delete;
+                Scope &operator=(const Scope &) = delete;
+        };
+
+        static std::pmr::memory_resource *resource() noexcept;
+
+        template <typename T>
+        static buffer<T> make_buffer() { return buffer<T>(resource()); }
+
+        template <typename T>
+        static buffer<T> adopt(std::vector<T> &&items) { return buffer<T>(items.begin(), items.end(), resource()); }
+
+        OptionalDouble cache_;
+        void cache_result(double value) { cache_ = OptionalDouble(value); }
+        OptionalDouble get_cached() const { return cache_; }
+    };
+
+    // Контейнер фиксированной емкости внутри объекта, без обращений к куче
+    template <typename T, size_t Capacity>
+    class InlineBuffer
+    {
+        std::array<T, Capacity> items_{};
+        size_t size_ = 0;
+
+        static void check_capacity(size_t count) {
+            if (count > Capacity) {
+                throw std::length_error("Превышена емкость встроенного хранилища");
+            }
+        }
+
+        public:
+            using value_type = T;
+            using iterator = T *;
+            using const_iterator = const T *;
+
+            template <typename Iterator>
+            void assign(Iterator first, Iterator last) {
+                check_capacity(static_cast<size_t>(std::distance(first, last)));
+                size_ = 0;
+                for (; first != last; ++first) items_[size_++] = *first;
+            }
+
+            void push_back(const T &value) {
+                check_capacity(size_ + 1);
+                items_[size_++] = value;
+            }
+
+            void clear() noexcept { size_ = 0; }
+
+            size_t size() const noexcept { return size_; }
+            bool empty() const noexcept { return size_ == 0; }
+            static constexpr size_t capacity() noexcept { return Capacity; }
+
+            T *data() noexcept { return items_.data(); }
+            const T *data() const noexcept { return items_.data(); }
+            T &operator[](size_t i) noexcept { return items_[i]; }
+            const T &operator[](size_t i) const noexcept { return items_[i]; }
+
+            iterator begin() noexcept { return items_.data(); }
+            iterator end() noexcept { return items_.data() + size_; }
+            const_iterator begin() const noexcept { return items_.data(); }
+            const_iterator end() const noexcept { return items_.data() + size_; }
+    };
+
+    // Треугольнику хватает трех вершин и трех индексов прямо в объекте
+    template <size_t Capacity = 3>
+    struct InlineStorage
+    {
+        template <typename T>
+        using buffer = InlineBuffer<T, Capacity>;
+
+        template <typename T>
+        static buffer<T> make_buffer() { return buffer<T>(); }
+
+        template <typename T>
+        static buffer<T> adopt(std::vector<T> &&items) {
+            buffer<T> result;
+            result.assign(items.begin(), items.end());
+            return result;
+        }
+
+        OptionalDouble cache_;
+        void cache_result(double value) { cache_ = OptionalDouble(value); }
+        OptionalDouble get_cached() const { return cache_; }
+    };
+
+    // Биты маски ошибок проверки; 0 - запись корректна
+    enum ValidationError : uint8_t
+    {
+        ValidationOk = 0,
+        NonPositiveSize = 1 << 0,
+        SizeTooLarge = 1 << 1,
+        NonFiniteValue = 1 << 2,
+        DegenerateTriangle = 1 << 3,
+        IndexOutOfRange = 1 << 4
+    };
+
     struct StrictValidation
     {
+        static constexpr double max_size = 1e6;
+
+        // Маска ошибок без ветвлений и исключений
+        static uint8_t check(double w, double h) noexcept {
+            const double limit = std::numeric_limits<double>::max();
+            return static_cast<uint8_t>(
+                ((w <= 0.0) | (h <= 0.0)) * NonPositiveSize
+              | ((w > max_size) | (h > max_size)) * SizeTooLarge
+              | (!(std::fabs(w) <= limit) | !(std::fabs(h) <= limit)) * NonFiniteValue);
+        }
+
+        static uint8_t check(double w, double h, double d) noexcept {
+            return static_cast<uint8_t>(check(w, h) | check(d, d));
+        }
+
         void validate(double w, double h) const;
         void validate(double w, double h, double d) const;
+        void validate(const Geometry3D::Point<double, 3> &a, const Geometry3D::Point<double, 3> &b,
+                      const Geometry3D::Point<double, 3> &c) const;
+
+        // Пакетная проверка: errors[i] получает маску i-й записи, возвращается число некорректных
+        static size_t validate_batch(std::span<const double> widths, std::span<const double> heights,
+                                     std::span<uint8_t> errors);
+
+        // Маска на каждый треугольник: IndexOutOfRange, NonFiniteValue или DegenerateTriangle
+        static size_t validate_triangles(std::span<const Geometry3D::Point<double, 3>> vertices,
+                                         std::span<const size_t> indices, std::span<uint8_t> errors);
+    };
+
+    // Проверка отключена: для доверенных данных на горячих путях
+    struct NoValidation
+    {
+        void validate(double, double) const noexcept {}
+        void validate(double, double, double) const noexcept {}
+        void validate(const Geometry3D::Point<double, 3> &, const Geometry3D::Point<double, 3> &,
+                      const Geometry3D::Point<double, 3> &) const noexcept {}
     };
 
     struct JSONSerialization
@@ -707,12 +1074,112 @@ namespace Geometry3D
                 auto end = std::chrono::high_resolution_clock::now();
                 return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
             }
+
+            // Среднее время одной фазы барьера в микросекундах
+            template <typename BarrierType>
+            static double measure_barrier(size_t threads, size_t phases = 1000)
+            {
+                BarrierType barrier(threads);
+                std::vector<std::thread> workers;
+                workers.reserve(threads - 1);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                for (size_t t = 1; t < threads; ++t) {
+                    workers.emplace_back([&barrier, phases]() {
+                        for (size_t p = 0; p < phases; ++p) barrier.arrive_and_wait();
+                    });
+                }
+                for (size_t p = 0; p < phases; ++p) barrier.arrive_and_wait();
+                for (auto& w : workers) w.join();
+                auto end = std::chrono::high_resolution_clock::now();
+
+                return std::chrono::duration<double, std::micro>(end - start).count() / phases;
+            }
+    };
+
+    struct StageTiming
+    {
+        std::string name;
+        size_t task_count;
+        double milliseconds;
+    };
+
+    class StageScheduler
+    {
+        using RangeBody = std::function<void(size_t, size_t)>;
+
+        struct Job
+        {
+            const RangeBody *body = nullptr;
+            size_t count = 0;
+            size_t grain = 1;
+            bool one_per_thread = false;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::exception_ptr error;
+        };
+
+        struct Stage
+        {
+            std::string name;
+            size_t task_count;
+            std::function<void(size_t)> body;
+            std::vector<size_t> dependencies;
+        };
+
+        std::vector<std::thread> workers_;
+        std::mutex mtx_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        std::shared_ptr<Job> job_;
+        size_t generation_ = 0;
+        bool stopping_ = false;
+        std::vector<Stage> stages_;
+
+        void worker_loop(size_t seen);
+        void run_job(Job &job);
+        void dispatch(const RangeBody &body, size_t count, size_t grain, bool one_per_thread);
+
+        public:
+            // 0 - по числу аппаратных потоков; вызывающий поток тоже участвует в работе
+            explicit StageScheduler(size_t worker_count = 0);
+            ~StageScheduler();
+
+            StageScheduler(const StageScheduler &) = delete;
+            StageScheduler &operator=(const StageScheduler &) = delete;
+
+            size_t worker_count() const noexcept { return workers_.size(); }
+            void ensure_workers(size_t count);
+
+            template <typename Body>
+            void parallel_for(size_t count, Body &&body)
+            {
+                const size_t participants = workers_.size() + 1;
+                const size_t grain = std::max<size_t>(1, count / (participants * 8));
+                RangeBody range = [&body](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        body(i);
+                    }
+                };
+                dispatch(range, count, grain, false);
+            }
+
+            // Каждый индекс выполняется в отдельном потоке, все одновременно (нужно для барьеров).
+            // Если пул уже занят, например при вызове из задачи, недостающие потоки создаются временно
+            void run_concurrently(size_t count, const std::function<void(size_t)> &body);
+
+            // Зависимости - номера ранее добавленных этапов
+            size_t add_stage(std::string name, size_t task_count, std::function<void(size_t)> body,
+                             std::vector<size_t> dependencies = {});
+            std::vector<StageTiming> run();
+            void clear_stages();
     };
 
     class ThreadManager
     {
         private:
             std::mutex cout_mutex_;
+            StageScheduler scheduler_;
             void safe_print(int thread_id, const std::string &message)
             {
                 std::lock_guard<std::mutex> lock(cout_mutex_);
@@ -724,15 +1191,11 @@ namespace Geometry3D
             {
                 std::cout << "\n   Этап \"" << stage_name << "\":" << std::endl;
 
+                // Задачи идут строго по очереди, поэтому отдельный поток для каждой не нужен
                 for (int i = 0; i < count; ++i) {
-                    std::thread t([this, i, &task]() {
-                        safe_print(i, "начал работу");
-                        task(i);
-                        safe_print(i, "завершил работу");
-                    });
-
-                    t.join();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    safe_print(i, "начал работу");
+                    task(i);
+                    safe_print(i, "завершил работу");
                 }
 
                 std::cout << "   Все потоки завершили этап \"" << stage_name << "\"" << std::endl;
@@ -743,25 +1206,17 @@ namespace Geometry3D
                 std::cout << "\n   Этап \"" << stage_name << "\":" << std::endl;
 
                 Barrier barrier(count);
-                std::vector<std::thread> parallel_threads;
-
-                for (int i = 0; i < count; ++i) {
-                    parallel_threads.emplace_back([this, i, &barrier, &task]() {
-                        safe_print(i, "начал подготовку");
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100 * (i + 1)));
-
-                        task(i, barrier);
-
-                        safe_print(i, "завершил работу");
-                    });
-                }
-
-                for (auto& t : parallel_threads) {
-                    t.join();
-                }
+                scheduler_.run_concurrently(static_cast<size_t>(count), [this, &barrier, &task](size_t index) {
+                    int i = static_cast<int>(index);
+                    safe_print(i, "начал подготовку");
+                    task(i, barrier);
+                    safe_print(i, "завершил работу");
+                });
 
                 std::cout << "   Все потоки синхронизированы" << std::endl;
             }
+
+            StageScheduler &scheduler() { return scheduler_; }
     };
 
 } // namespace Geometry3D
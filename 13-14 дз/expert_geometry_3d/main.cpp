@@ -1,10 +1,18 @@
+#ifdef _WIN32
 #include "dx12_raytracing.hpp"
+#endif
 #include "geometry3d.hpp"
+#include "mesh_intersection.hpp"
+#include "mesh_io.hpp"
+#include "mesh_reorder.hpp"
+#include "mesh_simplify.hpp"
+#include "render_loop.hpp"
 #include <QApplication>
 #include <QMainWindow>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
+#include <QFileDialog>
 #include <QPushButton>
 #include <QLineEdit>
 #include <QMenuBar>
@@ -17,12 +25,19 @@
 #include <QTimer>
 #include <locale>
 #include <string>
-#include <thread
+#include <thread>
 #include <chrono>
 #include <QDebug>
 
 using namespace Geometry3D;
 
+// Неизменяемый снимок сцены, который интерфейс передает потоку отрисовки
+struct SceneSnapshot
+{
+    AdvancedBox<HeapStorage, StrictValidation, JSONSerialization> box;
+    uint64_t version = 0;
+};
+
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
@@ -34,6 +49,13 @@ class MainWindow : public QMainWindow {
             startRendering();
         }
 
+        ~MainWindow() {
+            renderLoop.stop();
+#ifdef _WIN32
+            delete dx12Renderer;
+#endif
+        }
+
     private slots:
         void updateGeometry() {
             try {
@@ -54,7 +76,7 @@ class MainWindow : public QMainWindow {
                 );
 
                 updateUI();
-                dx12Renderer->UpdateGeometry(box);
+                publishScene();
             } catch (const std::exception& e) {
                 std::cerr << "Ошибка обновления геометрии: " << e.what() << std::endl;
             }
@@ -73,6 +95,31 @@ class MainWindow : public QMainWindow {
             updateGeometry();
         }
 
+        void openModel() {
+            QString fileName = QFileDialog::getOpenFileName(
+                this,
+                "Открыть модель",
+                QString(),
+                "Модели (*.obj *.stl *.ply)"
+            );
+            if (fileName.isEmpty()) {
+                return;
+            }
+
+            try {
+                MeshData mesh = load_mesh(std::filesystem::path(fileName.toStdWString()), &importScheduler);
+                reorder_morton(mesh, &importScheduler);
+                box = AdvancedBox<HeapStorage, StrictValidation, JSONSerialization>(
+                    std::move(mesh.vertices),
+                    std::move(mesh.indices)
+                );
+                updateUI();
+                publishScene();
+            } catch (const std::exception& e) {
+                QMessageBox::warning(this, "Ошибка загрузки", QString::fromUtf8(e.what()));
+            }
+        }
+
         void showAbout() {
             QMessageBox::about
             (
@@ -87,7 +134,7 @@ class MainWindow : public QMainWindow {
             surfaceAreaLabel->setText(QString("Площадь поверхности: %1").arg(box.surface_area()));
             auto centroid = box.centroid_3d();
             centroidLabel->setText(QString("Центр масс: (%1, %2, %3)").arg(centroid[0]).arg(centroid[1]).arg(centroid[2]));
-            fpsLabel->setText(QString("FPS: %1").arg(dx12Renderer->GetFPS()));
+            fpsLabel->setText(QString("FPS: %1").arg(renderLoop.fps()));
         }
 
     private:
@@ -96,6 +143,8 @@ class MainWindow : public QMainWindow {
             resize(1000, 700);
             QMenuBar *menuBar = this->menuBar();
             QMenu *fileMenu = menuBar->addMenu("Файл");
+            QAction *openAction = fileMenu->addAction("Открыть модель...");
+            connect(openAction, &QAction::triggered, this, &MainWindow::openModel);
             QAction *exitAction = fileMenu->addAction("Выход");
             connect(exitAction, &QAction::triggered, this, &QWidget::close);
             QMenu *viewMenu = menuBar->addMenu("Вид");
@@ -184,34 +233,56 @@ class MainWindow : public QMainWindow {
             );
         }
 
+        // DX12 есть только в Windows и не создается на платформе offscreen (тесты без окна),
+        // но снимки сцены в любом случае передаются в поток отрисовки
         void setupRendering() {
-            dx12Renderer = new DX12RayTracing(
-                (
-                    HWND
-                )renderWindow->winId(), 
-                600, 
-                400
-            );
-            dx12Renderer->Initialize();
-            dx12Renderer->UpdateGeometry(box);
+#ifdef _WIN32
+            if (QGuiApplication::platformName() != "offscreen") {
+                dx12Renderer = new DX12RayTracing(
+                    (
+                        HWND
+                    )renderWindow->winId(), 
+                    600, 
+                    400
+                );
+                dx12Renderer->Initialize();
+            }
+#endif
+            publishScene();
         }
 
+        // Отрисовка идет в отдельном потоке; интерфейс только публикует снимки и не ждет кадр
         void startRendering() {
-            renderTimer = new QTimer(this);
-            connect(
-                renderTimer, 
-                &QTimer::timeout, 
-                [this]() {
+            renderLoop.start([this]() {
+#ifdef _WIN32
+                if (scene.acquire() && dx12Renderer) {
+                    dx12Renderer->UpdateGeometry(scene.front().box);
+                }
+                if (dx12Renderer) {
                     dx12Renderer->Render();
                 }
-            );
-            renderTimer->start(16);
+#else
+                scene.acquire();
+#endif
+            });
+        }
+
+        void publishScene() {
+            SceneSnapshot &next = scene.back();
+            next.box = box;
+            next.version = ++sceneVersion;
+            scene.publish();
         }
 
         AdvancedBox<HeapStorage, StrictValidation, JSONSerialization> box;
-        DX12RayTracing *dx12Renderer;
+        StageScheduler importScheduler;
+        TripleBuffer<SceneSnapshot> scene;
+        uint64_t sceneVersion = 0;
+        RenderLoop renderLoop;
+#ifdef _WIN32
+        DX12RayTracing *dx12Renderer = nullptr;
+#endif
         QWindow *renderWindow;
-        QTimer *renderTimer;
         QLineEdit *vertex1XEdit, *vertex1YEdit, *vertex1ZEdit;
         QLineEdit *vertex2XEdit, *vertex2YEdit, *vertex2ZEdit;
         QLineEdit *vertex3XEdit, *vertex3YEdit, *vertex3ZEdit;
@@ -219,6 +290,20 @@ class MainWindow : public QMainWindow {
         QToolBar *toolBar;
 };
 
+// Строит сцену из count треугольников и возвращает время в миллисекундах
+template <typename Box>
+double build_triangle_scene(size_t count) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<Box> scene;
+    scene.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(i);
+        scene.emplace_back(Point<double,3>(x, 0, 0), Point<double,3>(x + 1, 0, 0), Point<double,3>(x, 1, 0));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
     std::cout << "Qt version: " << qVersion() << std::endl;
@@ -293,6 +378,21 @@ int main(int argc, char *argv[]) {
         }, 4, "Масштабирование 3D");
         
         std::cout << "   Итоговый объем после масштабирования: " << box.volume() << std::endl;
+
+        // Объем замкнутой сетки после scale(k) растет в k^3 раз, поворот его не меняет
+        AdvancedBox<HeapStorage, StrictValidation, JSONSerialization> cube(
+            {{0, 0, 0}, {2, 0, 0}, {2, 2, 0}, {0, 2, 0}, {0, 0, 2}, {2, 0, 2}, {2, 2, 2}, {0, 2, 2}},
+            {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+             1, 2, 6, 1, 6, 5, 2, 3, 7, 2, 7, 6, 3, 0, 4, 3, 4, 7});
+        const double cube_volume = cube.volume();
+        const double cube_factor = 2.0;
+        cube.scale(cube_factor);
+        cube.rotate_z(0.5);
+        const double expected_volume = cube_volume * cube_factor * cube_factor * cube_factor;
+        std::cout << "   Объем куба: " << cube_volume << " -> " << cube.volume()
+                  << " (ожидалось " << expected_volume << ", "
+                  << (std::fabs(cube.volume() - expected_volume) <= 1e-9 * expected_volume ? "совпадает" : "НЕ совпадает")
+                  << ")" << std::endl;
         
         thread_manager.execute_with_barrier(
             [](int id, Barrier& barrier) {
@@ -375,6 +475,73 @@ int main(int argc, char *argv[]) {
         std::cout << "   Объем: " << box2.volume() << ", Площадь поверхности: " << box2.surface_area() << std::endl;
         std::cout << "   Центр масс: " << box2.centroid_3d() << std::endl;
         std::cout << "   Сериализация: " << box2.serialize() << std::endl;
+
+        std::cout << "\n15. Пересечение треугольников:" << std::endl;
+
+        AdvancedBox<HeapStorage, 
+        StrictValidation, 
+        JSONSerialization> crossing(
+            Point<double,3>(0.5,0.5,-1), 
+            Point<double,3>(0.5,0.5,1), 
+            Point<double,3>(2,2,0)
+        );
+
+        std::cout << "   Первый и второй треугольники пересекаются: " 
+                  << (meshes_intersect(box2, crossing) ? "да" : "нет") << std::endl;
+        std::cout << "   Пар пересекающихся треугольников: " 
+                  << intersecting_pairs(box2, crossing, &thread_manager.scheduler()).size() << std::endl;
+
+        std::cout << "\n16. Уровни детализации:" << std::endl;
+
+        // Полюс - одна вершина: sin(PI) не равен нулю точно, и кольцо вершин на полюсе не сварилось бы
+        MeshData sphere;
+        const size_t rings = 64, sectors = 128;
+        const size_t south_pole = 1 + (rings - 1) * sectors;
+        sphere.vertices.emplace_back(0.0, 0.0, 1.0);
+        for (size_t i = 1; i < rings; ++i) {
+            for (size_t j = 0; j < sectors; ++j) {
+                double theta = PI * i / rings, phi = 2.0 * PI * j / sectors;
+                sphere.vertices.emplace_back(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+            }
+        }
+        sphere.vertices.emplace_back(0.0, 0.0, -1.0);
+
+        auto sphere_vertex = [&](size_t i, size_t j) -> size_t {
+            if (i == 0) return 0;
+            if (i == rings) return south_pole;
+            return 1 + (i - 1) * sectors + j % sectors;
+        };
+        for (size_t i = 0; i < rings; ++i) {
+            for (size_t j = 0; j < sectors; ++j) {
+                size_t a = sphere_vertex(i, j), b = sphere_vertex(i + 1, j);
+                size_t c = sphere_vertex(i + 1, j + 1), d = sphere_vertex(i, j + 1);
+                if (i + 1 < rings) sphere.indices.insert(sphere.indices.end(), {a, b, c});
+                if (i > 0) sphere.indices.insert(sphere.indices.end(), {a, c, d});
+            }
+        }
+
+        for (const LodLevel& level : build_lod_chain(sphere, 4)) {
+            std::cout << "   Треугольников: " << level.mesh.indices.size() / 3 
+                      << ", ошибка: " << level.error
+                      << ", объем: " << compute_mass_properties(level.mesh.vertices, level.mesh.indices).volume << std::endl;
+        }
+
+        std::cout << "\n17. Политики хранения (100000 треугольников):" << std::endl;
+
+        const size_t scene_size = 100000;
+        std::cout << "   HeapStorage: " 
+                  << build_triangle_scene<AdvancedBox<HeapStorage, StrictValidation, JSONSerialization>>(scene_size) 
+                  << " мс" << std::endl;
+        {
+            std::pmr::monotonic_buffer_resource arena(scene_size * 128);
+            ArenaStorage::Scope scope(arena);
+            std::cout << "   ArenaStorage: " 
+                      << build_triangle_scene<AdvancedBox<ArenaStorage, StrictValidation, JSONSerialization>>(scene_size) 
+                      << " мс" << std::endl;
+        }
+        std::cout << "   InlineStorage<3>: " 
+                  << build_triangle_scene<AdvancedBox<InlineStorage<3>, StrictValidation, JSONSerialization>>(scene_size) 
+                  << " мс" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "\nКритическая ошибка: " << e.what() << std::endl;
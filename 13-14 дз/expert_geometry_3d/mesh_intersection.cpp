@@ -0,0 +1,278 @@
+#include "mesh_intersection.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Geometry3D {
+
+    namespace {
+        using Vec3 = std::array<double, 3>;
+
+        inline Vec3 sub(const Point3& a, const Point3& b) {
+            return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+        }
+
+        inline Vec3 cross(const Vec3& a, const Vec3& b) {
+            return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        }
+
+        // Ребро одного треугольника разделяет треугольники, если другой целиком снаружи
+        bool separated_by_edges_2d(const double (*a)[2], const double (*b)[2]) {
+            double orientation = orient2d(a[0], a[1], a[2]);
+            if (orientation == 0.0) return false;
+            const bool counterclockwise = orientation > 0.0;
+            for (int e = 0; e < 3; ++e) {
+                const double* from = a[e];
+                const double* to = a[(e + 1) % 3];
+                bool all_outside = true;
+                for (int v = 0; v < 3 && all_outside; ++v) {
+                    const double* point = b[v];
+                    const double side = orient2d(from, to, point);
+                    all_outside = counterclockwise ? side < 0.0 : side > 0.0;
+                }
+                if (all_outside) return true;
+            }
+            return false;
+        }
+
+        bool coplanar_triangles_intersect(const Point3& p1, const Point3& q1, const Point3& r1,
+                                          const Point3& p2, const Point3& q2, const Point3& r2) {
+            // Проекция на координатную плоскость, где нормаль имеет наибольшую компоненту
+            Vec3 normal = cross(sub(q1, p1), sub(r1, p1));
+            double nx = std::fabs(normal[0]), ny = std::fabs(normal[1]), nz = std::fabs(normal[2]);
+            int u = 0, v = 1;
+            if (nx >= ny && nx >= nz) {
+                u = 1; v = 2;
+            } else if (ny >= nz) {
+                u = 0; v = 2;
+            }
+
+            const Point3* first[3] = {&p1, &q1, &r1};
+            const Point3* second[3] = {&p2, &q2, &r2};
+            double a[3][2], b[3][2];
+            for (int i = 0; i < 3; ++i) {
+                a[i][0] = (*first[i])[u]; a[i][1] = (*first[i])[v];
+                b[i][0] = (*second[i])[u]; b[i][1] = (*second[i])[v];
+            }
+            return !separated_by_edges_2d(a, b) && !separated_by_edges_2d(b, a);
+        }
+
+        bool check_min_max(const Point3& p1, const Point3& q1, const Point3& r1,
+                           const Point3& p2, const Point3& q2, const Point3& r2) {
+            if (orient3d(q1, p2, p1, q2) > 0.0) return false;
+            if (orient3d(p1, p2, r1, r2) > 0.0) return false;
+            return true;
+        }
+
+        // p1 лежит по одну сторону плоскости второго треугольника, q1 и r1 - по другую
+        bool tri_tri_3d(const Point3& p1, const Point3& q1, const Point3& r1,
+                        const Point3& p2, const Point3& q2, const Point3& r2,
+                        double dp2, double dq2, double dr2) {
+            if (dp2 > 0.0) {
+                if (dq2 > 0.0) return check_min_max(p1, r1, q1, r2, p2, q2);
+                if (dr2 > 0.0) return check_min_max(p1, r1, q1, q2, r2, p2);
+                return check_min_max(p1, q1, r1, p2, q2, r2);
+            }
+            if (dp2 < 0.0) {
+                if (dq2 < 0.0) return check_min_max(p1, q1, r1, r2, p2, q2);
+                if (dr2 < 0.0) return check_min_max(p1, q1, r1, q2, r2, p2);
+                return check_min_max(p1, r1, q1, p2, q2, r2);
+            }
+            if (dq2 < 0.0) {
+                if (dr2 >= 0.0) return check_min_max(p1, r1, q1, q2, r2, p2);
+                return check_min_max(p1, q1, r1, p2, q2, r2);
+            }
+            if (dq2 > 0.0) {
+                if (dr2 > 0.0) return check_min_max(p1, r1, q1, p2, q2, r2);
+                return check_min_max(p1, q1, r1, q2, r2, p2);
+            }
+            if (dr2 > 0.0) return check_min_max(p1, q1, r1, r2, p2, q2);
+            if (dr2 < 0.0) return check_min_max(p1, r1, q1, r2, p2, q2);
+            return coplanar_triangles_intersect(p1, q1, r1, p2, q2, r2);
+        }
+    }
+
+    Aabb3D Aabb3D::empty() {
+        const double inf = std::numeric_limits<double>::infinity();
+        return {{inf, inf, inf}, {-inf, -inf, -inf}};
+    }
+
+    Aabb3D Aabb3D::of_triangle(const Point3& a, const Point3& b, const Point3& c) {
+        Aabb3D box;
+        for (size_t k = 0; k < 3; ++k) {
+            box.min[k] = std::min({a[k], b[k], c[k]});
+            box.max[k] = std::max({a[k], b[k], c[k]});
+        }
+        return box;
+    }
+
+    void Aabb3D::expand(const Aabb3D& other) {
+        for (size_t k = 0; k < 3; ++k) {
+            min[k] = std::min(min[k], other.min[k]);
+            max[k] = std::max(max[k], other.max[k]);
+        }
+    }
+
+    bool triangles_intersect(const Point3& p1, const Point3& q1, const Point3& r1,
+                             const Point3& p2, const Point3& q2, const Point3& r2) {
+        const double dp1 = orient3d(p2, q2, r2, p1);
+        const double dq1 = orient3d(p2, q2, r2, q1);
+        const double dr1 = orient3d(p2, q2, r2, r1);
+        if ((dp1 > 0.0 && dq1 > 0.0 && dr1 > 0.0) || (dp1 < 0.0 && dq1 < 0.0 && dr1 < 0.0)) return false;
+
+        const double dp2 = orient3d(p1, q1, r1, p2);
+        const double dq2 = orient3d(p1, q1, r1, q2);
+        const double dr2 = orient3d(p1, q1, r1, r2);
+        if ((dp2 > 0.0 && dq2 > 0.0 && dr2 > 0.0) || (dp2 < 0.0 && dq2 < 0.0 && dr2 < 0.0)) return false;
+
+        // Переставляем вершины первого треугольника так, чтобы p1 оказалась одна по свою сторону
+        if (dp1 > 0.0) {
+            if (dq1 > 0.0) return tri_tri_3d(r1, p1, q1, p2, r2, q2, dp2, dr2, dq2);
+            if (dr1 > 0.0) return tri_tri_3d(q1, r1, p1, p2, r2, q2, dp2, dr2, dq2);
+            return tri_tri_3d(p1, q1, r1, p2, q2, r2, dp2, dq2, dr2);
+        }
+        if (dp1 < 0.0) {
+            if (dq1 < 0.0) return tri_tri_3d(r1, p1, q1, p2, q2, r2, dp2, dq2, dr2);
+            if (dr1 < 0.0) return tri_tri_3d(q1, r1, p1, p2, q2, r2, dp2, dq2, dr2);
+            return tri_tri_3d(p1, q1, r1, p2, r2, q2, dp2, dr2, dq2);
+        }
+        if (dq1 < 0.0) {
+            if (dr1 >= 0.0) return tri_tri_3d(q1, r1, p1, p2, r2, q2, dp2, dr2, dq2);
+            return tri_tri_3d(p1, q1, r1, p2, q2, r2, dp2, dq2, dr2);
+        }
+        if (dq1 > 0.0) {
+            if (dr1 > 0.0) return tri_tri_3d(p1, q1, r1, p2, r2, q2, dp2, dr2, dq2);
+            return tri_tri_3d(q1, r1, p1, p2, q2, r2, dp2, dq2, dr2);
+        }
+        if (dr1 > 0.0) return tri_tri_3d(r1, p1, q1, p2, q2, r2, dp2, dq2, dr2);
+        if (dr1 < 0.0) return tri_tri_3d(r1, p1, q1, p2, r2, q2, dp2, dr2, dq2);
+        return coplanar_triangles_intersect(p1, q1, r1, p2, q2, r2);
+    }
+
+    TriangleBvh::TriangleBvh(std::span<const Point3> vertices, std::span<const size_t> indices) {
+        const size_t count = indices.size() / 3;
+        triangle_bounds_.resize(count);
+        order_.resize(count);
+        std::vector<Point3> centroids(count);
+        for (size_t t = 0; t < count; ++t) {
+            const Point3& a = vertices[indices[3 * t]];
+            const Point3& b = vertices[indices[3 * t + 1]];
+            const Point3& c = vertices[indices[3 * t + 2]];
+            triangle_bounds_[t] = Aabb3D::of_triangle(a, b, c);
+            centroids[t] = Point3((a[0] + b[0] + c[0]) / 3.0, (a[1] + b[1] + c[1]) / 3.0, (a[2] + b[2] + c[2]) / 3.0);
+            order_[t] = static_cast<uint32_t>(t);
+        }
+        if (count == 0) return;
+
+        nodes_.reserve(2 * (count / leaf_size + 1));
+        nodes_.emplace_back();
+        build(0, 0, static_cast<uint32_t>(count), centroids);
+    }
+
+    void TriangleBvh::build(uint32_t node, uint32_t begin, uint32_t end, const std::vector<Point3>& centroids) {
+        Aabb3D bounds = Aabb3D::empty();
+        Aabb3D centroid_bounds = Aabb3D::empty();
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds.expand(triangle_bounds_[order_[i]]);
+            const Point3& c = centroids[order_[i]];
+            centroid_bounds.expand(Aabb3D::of_triangle(c, c, c));
+        }
+        nodes_[node].bounds = bounds;
+
+        if (end - begin <= leaf_size) {
+            nodes_[node].first = begin;
+            nodes_[node].count = end - begin;
+            return;
+        }
+
+        size_t axis = 0;
+        for (size_t k = 1; k < 3; ++k) {
+            if (centroid_bounds.max[k] - centroid_bounds.min[k] > centroid_bounds.max[axis] - centroid_bounds.min[axis]) {
+                axis = k;
+            }
+        }
+
+        const uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(order_.begin() + begin, order_.begin() + middle, order_.begin() + end,
+            [&centroids, axis](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        const uint32_t left = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_.emplace_back();
+        nodes_[node].first = left;
+        nodes_[node].count = 0;
+        build(left, begin, middle, centroids);
+        build(left + 1, middle, end, centroids);
+    }
+
+    namespace {
+        struct TriangleRef
+        {
+            std::span<const Point3> vertices;
+            std::span<const size_t> indices;
+
+            const Point3& operator()(size_t triangle, size_t corner) const {
+                return vertices[indices[3 * triangle + corner]];
+            }
+        };
+
+        void collect_pairs(const TriangleRef& a, const TriangleRef& b, const TriangleBvh& bvh,
+                           size_t begin, size_t end, std::vector<TrianglePair>& out) {
+            for (size_t t = begin; t < end; ++t) {
+                const Aabb3D box = Aabb3D::of_triangle(a(t, 0), a(t, 1), a(t, 2));
+                bvh.query(box, [&](size_t other) {
+                    if (triangles_intersect(a(t, 0), a(t, 1), a(t, 2), b(other, 0), b(other, 1), b(other, 2))) {
+                        out.emplace_back(t, other);
+                    }
+                    return false;
+                });
+            }
+        }
+    }
+
+    std::vector<TrianglePair> intersecting_triangle_pairs(std::span<const Point3> vertices_a, std::span<const size_t> indices_a,
+                                                          std::span<const Point3> vertices_b, std::span<const size_t> indices_b,
+                                                          StageScheduler* scheduler) {
+        const TriangleRef a{vertices_a, indices_a};
+        const TriangleRef b{vertices_b, indices_b};
+        const TriangleBvh bvh(vertices_b, indices_b);
+        const size_t count = indices_a.size() / 3;
+
+        std::vector<TrianglePair> result;
+        if (!scheduler) {
+            collect_pairs(a, b, bvh, 0, count, result);
+            return result;
+        }
+
+        // Блоки фиксированного размера: результат склеивается в порядке треугольников A
+        const size_t block_size = 1024;
+        const size_t blocks = (count + block_size - 1) / block_size;
+        std::vector<std::vector<TrianglePair>> partial(blocks);
+        scheduler->parallel_for(blocks, [&](size_t block) {
+            collect_pairs(a, b, bvh, block * block_size, std::min(count, (block + 1) * block_size), partial[block]);
+        });
+
+        size_t total = 0;
+        for (const auto& part : partial) total += part.size();
+        result.reserve(total);
+        for (const auto& part : partial) result.insert(result.end(), part.begin(), part.end());
+        return result;
+    }
+
+    bool meshes_intersect(std::span<const Point3> vertices_a, std::span<const size_t> indices_a,
+                          std::span<const Point3> vertices_b, std::span<const size_t> indices_b) {
+        const TriangleRef a{vertices_a, indices_a};
+        const TriangleRef b{vertices_b, indices_b};
+        const TriangleBvh bvh(vertices_b, indices_b);
+        const size_t count = indices_a.size() / 3;
+
+        for (size_t t = 0; t < count; ++t) {
+            const Aabb3D box = Aabb3D::of_triangle(a(t, 0), a(t, 1), a(t, 2));
+            bool hit = bvh.query(box, [&](size_t other) {
+                return triangles_intersect(a(t, 0), a(t, 1), a(t, 2), b(other, 0), b(other, 1), b(other, 2));
+            });
+            if (hit) return true;
+        }
+        return false;
+    }
+
+} // namespace Geometry3D
@@ -0,0 +1,107 @@
+#ifndef MESH_INTERSECTION_HPP
+#define MESH_INTERSECTION_HPP
+
+#include "geometry3d.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Geometry3D
+{
+    using Point3 = Point<double, 3>;
+    using TrianglePair = std::pair<size_t, size_t>;
+
+    struct Aabb3D
+    {
+        double min[3];
+        double max[3];
+
+        static Aabb3D empty();
+        static Aabb3D of_triangle(const Point3 &a, const Point3 &b, const Point3 &c);
+
+        void expand(const Aabb3D &other);
+        bool overlaps(const Aabb3D &other) const noexcept {
+            return min[0] <= other.max[0] && other.min[0] <= max[0]
+                && min[1] <= other.max[1] && other.min[1] <= max[1]
+                && min[2] <= other.max[2] && other.min[2] <= max[2];
+        }
+    };
+
+    // Точный тест пересечения треугольников (Guigue–Devillers), касание считается пересечением
+    bool triangles_intersect(const Point3 &p1, const Point3 &q1, const Point3 &r1,
+                             const Point3 &p2, const Point3 &q2, const Point3 &r2);
+
+    // BVH по треугольникам сетки, узлы хранятся в плоском массиве
+    class TriangleBvh
+    {
+        struct Node
+        {
+            Aabb3D bounds;
+            uint32_t first;   // лист: первый треугольник в order_, узел: левый потомок
+            uint32_t count;   // 0 у внутреннего узла
+        };
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> order_;
+        std::vector<Aabb3D> triangle_bounds_;
+
+        void build(uint32_t node, uint32_t begin, uint32_t end, const std::vector<Point3> &centroids);
+
+        public:
+            static constexpr uint32_t leaf_size = 4;
+
+            TriangleBvh(std::span<const Point3> vertices, std::span<const size_t> indices);
+
+            const Aabb3D &triangle_bounds(size_t triangle) const { return triangle_bounds_[triangle]; }
+
+            // visitor(triangle) вызывается для каждого треугольника, чей AABB пересекает box;
+            // если visitor возвращает true, обход прекращается
+            template <typename Visitor>
+            bool query(const Aabb3D &box, Visitor &&visitor) const
+            {
+                if (nodes_.empty()) return false;
+                uint32_t stack[64];
+                size_t top = 0;
+                stack[top++] = 0;
+                while (top > 0) {
+                    const Node &node = nodes_[stack[--top]];
+                    if (!node.bounds.overlaps(box)) continue;
+                    if (node.count > 0) {
+                        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                            if (triangle_bounds_[order_[i]].overlaps(box) && visitor(order_[i])) {
+                                return true;
+                            }
+                        }
+                    } else {
+                        stack[top++] = node.first;
+                        stack[top++] = node.first + 1;
+                    }
+                }
+                return false;
+            }
+    };
+
+    // Все пары (треугольник A, треугольник B), которые пересекаются; порядок не зависит от числа потоков
+    std::vector<TrianglePair> intersecting_triangle_pairs(std::span<const Point3> vertices_a, std::span<const size_t> indices_a,
+                                                          std::span<const Point3> vertices_b, std::span<const size_t> indices_b,
+                                                          StageScheduler *scheduler = nullptr);
+
+    bool meshes_intersect(std::span<const Point3> vertices_a, std::span<const size_t> indices_a,
+                          std::span<const Point3> vertices_b, std::span<const size_t> indices_b);
+
+    template <typename MeshA, typename MeshB>
+    std::vector<TrianglePair> intersecting_pairs(const MeshA &a, const MeshB &b, StageScheduler *scheduler = nullptr)
+    {
+        return intersecting_triangle_pairs(a.get_vertices(), a.get_indices(), b.get_vertices(), b.get_indices(), scheduler);
+    }
+
+    template <typename MeshA, typename MeshB>
+    bool meshes_intersect(const MeshA &a, const MeshB &b)
+    {
+        return meshes_intersect(a.get_vertices(), a.get_indices(), b.get_vertices(), b.get_indices());
+    }
+
+} // namespace Geometry3D
+
+#endif // MESH_INTERSECTION_HPP
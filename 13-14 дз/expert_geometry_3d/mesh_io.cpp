@@ -0,0 +1,708 @@
+#include "mesh_io.hpp"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <sstream>
+#include <numeric>
+#include <cstring>
+#include <cctype>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Geometry3D {
+
+    using Point3 = Point<double, 3>;
+
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Не удалось открыть файл " + path.string());
+        }
+        file_ = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось определить размер файла " + path.string());
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ == 0) return;
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось отобразить файл " + path.string());
+        }
+        mapping_ = mapping;
+        data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data_) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось отобразить файл " + path.string());
+        }
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("Не удалось открыть файл " + path.string());
+        }
+
+        struct stat info;
+        if (::fstat(fd_, &info) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("Не удалось определить размер файла " + path.string());
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ == 0) return;
+
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("Не удалось отобразить файл " + path.string());
+        }
+        ::madvise(mapped, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapped);
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+        if (file_) CloseHandle(static_cast<HANDLE>(file_));
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    namespace {
+        using Range = std::pair<const char*, const char*>;
+
+        // Границы кусков сдвигаются на начало следующей строки
+        std::vector<Range> split_at_lines(const char* begin, const char* end, size_t parts) {
+            std::vector<Range> ranges;
+            const size_t length = static_cast<size_t>(end - begin);
+            const char* start = begin;
+            for (size_t i = 1; i <= parts && start < end; ++i) {
+                const char* stop = i == parts ? end : begin + length * i / parts;
+                if (stop < start) stop = start;
+                if (stop < end) {
+                    const void* newline = std::memchr(stop, '\n', static_cast<size_t>(end - stop));
+                    stop = newline ? static_cast<const char*>(newline) + 1 : end;
+                }
+                ranges.emplace_back(start, stop);
+                start = stop;
+            }
+            return ranges;
+        }
+
+        size_t chunk_count(size_t bytes, StageScheduler* scheduler) {
+            if (!scheduler) return 1;
+            const size_t by_size = std::max<size_t>(1, bytes / (1 << 16));
+            return std::min((scheduler->worker_count() + 1) * 4, by_size);
+        }
+
+        template <typename Body>
+        void for_each_chunk(StageScheduler* scheduler, size_t count, Body&& body) {
+            if (scheduler && count > 1) {
+                scheduler->parallel_for(count, body);
+            } else {
+                for (size_t i = 0; i < count; ++i) body(i);
+            }
+        }
+
+        template <typename T>
+        std::vector<T> concatenate(std::vector<std::vector<T>>& parts) {
+            if (parts.size() == 1) return std::move(parts[0]);
+            size_t total = 0;
+            for (const auto& part : parts) total += part.size();
+            std::vector<T> result;
+            result.reserve(total);
+            for (auto& part : parts) {
+                result.insert(result.end(), part.begin(), part.end());
+                std::vector<T>().swap(part);
+            }
+            return result;
+        }
+
+        inline bool is_blank(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline void skip_blanks(const char*& p, const char* end) {
+            while (p < end && is_blank(*p)) ++p;
+        }
+
+        inline const char* next_line(const char* p, const char* end) {
+            const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+            return newline ? static_cast<const char*>(newline) + 1 : end;
+        }
+
+        inline bool starts_with(const char* p, const char* end, const char* word) {
+            const size_t length = std::strlen(word);
+            return static_cast<size_t>(end - p) >= length && std::memcmp(p, word, length) == 0;
+        }
+
+        inline bool parse_double(const char*& p, const char* end, double& value) {
+            skip_blanks(p, end);
+            if (p < end && *p == '+') ++p;
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        inline bool parse_integer(const char*& p, const char* end, long long& value) {
+            skip_blanks(p, end);
+            if (p < end && *p == '+') ++p;
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        inline void skip_token(const char*& p, const char* end) {
+            skip_blanks(p, end);
+            while (p < end && !is_blank(*p) && *p != '\n') ++p;
+        }
+
+        size_t checked_index(long long index, size_t vertex_count) {
+            if (index < 0 || static_cast<unsigned long long>(index) >= vertex_count) {
+                throw std::out_of_range("Индекс вершины вне диапазона");
+            }
+            return static_cast<size_t>(index);
+        }
+
+        void append_fan(const std::vector<long long>& polygon, std::vector<long long>& out) {
+            for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+                out.push_back(polygon[0]);
+                out.push_back(polygon[k]);
+                out.push_back(polygon[k + 1]);
+            }
+        }
+
+        // ------------------------------------------------------------ OBJ
+
+        struct ObjChunk
+        {
+            std::vector<Point3> vertices;
+            std::vector<long long> faces;
+            std::vector<size_t> relative;   // позиции в faces, к которым нужно прибавить смещение куска
+        };
+
+        void parse_obj_chunk(const char* p, const char* end, ObjChunk& chunk) {
+            std::vector<long long> polygon;
+            std::vector<bool> polygon_relative;
+            while (p < end) {
+                const char* line_end = next_line(p, end);
+                skip_blanks(p, line_end);
+                if (line_end - p >= 2 && p[0] == 'v' && is_blank(p[1])) {
+                    ++p;
+                    double x = 0, y = 0, z = 0;
+                    if (!parse_double(p, line_end, x) || !parse_double(p, line_end, y) || !parse_double(p, line_end, z)) {
+                        throw std::runtime_error("OBJ: некорректная вершина");
+                    }
+                    chunk.vertices.emplace_back(x, y, z);
+                } else if (line_end - p >= 2 && p[0] == 'f' && is_blank(p[1])) {
+                    ++p;
+                    polygon.clear();
+                    polygon_relative.clear();
+                    long long index = 0;
+                    while (parse_integer(p, line_end, index)) {
+                        if (index > 0) {
+                            polygon.push_back(index - 1);
+                            polygon_relative.push_back(false);
+                        } else if (index < 0) {
+                            polygon.push_back(static_cast<long long>(chunk.vertices.size()) + index);
+                            polygon_relative.push_back(true);
+                        } else {
+                            throw std::runtime_error("OBJ: нулевой индекс вершины");
+                        }
+                        while (p < line_end && !is_blank(*p) && *p != '\n') ++p;   // пропуск /vt/vn
+                    }
+                    for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+                        for (size_t corner : {size_t(0), k, k + 1}) {
+                            if (polygon_relative[corner]) chunk.relative.push_back(chunk.faces.size());
+                            chunk.faces.push_back(polygon[corner]);
+                        }
+                    }
+                }
+                p = line_end;
+            }
+        }
+
+        // ------------------------------------------------------------ PLY
+
+        enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+        struct PlyProperty
+        {
+            std::string name;
+            bool is_list = false;
+            PlyType type = PlyType::Float32;
+            PlyType count_type = PlyType::UInt8;
+        };
+
+        struct PlyElement
+        {
+            std::string name;
+            size_t count = 0;
+            std::vector<PlyProperty> properties;
+        };
+
+        PlyType parse_ply_type(const std::string& name) {
+            if (name == "char" || name == "int8") return PlyType::Int8;
+            if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+            if (name == "short" || name == "int16") return PlyType::Int16;
+            if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+            if (name == "int" || name == "int32") return PlyType::Int32;
+            if (name == "uint" || name == "uint32") return PlyType::UInt32;
+            if (name == "float" || name == "float32") return PlyType::Float32;
+            if (name == "double" || name == "float64") return PlyType::Float64;
+            throw std::runtime_error("PLY: неизвестный тип " + name);
+        }
+
+        size_t ply_type_size(PlyType type) {
+            switch (type) {
+                case PlyType::Int8: case PlyType::UInt8: return 1;
+                case PlyType::Int16: case PlyType::UInt16: return 2;
+                case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+                case PlyType::Float64: return 8;
+            }
+            return 0;
+        }
+
+        template <typename T>
+        T load_scalar(const char* p, bool swap) {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, p, sizeof(T));
+            if (swap) std::reverse(bytes, bytes + sizeof(T));
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+
+        double read_ply_binary(const char* p, PlyType type, bool swap) {
+            switch (type) {
+                case PlyType::Int8: return load_scalar<int8_t>(p, swap);
+                case PlyType::UInt8: return load_scalar<uint8_t>(p, swap);
+                case PlyType::Int16: return load_scalar<int16_t>(p, swap);
+                case PlyType::UInt16: return load_scalar<uint16_t>(p, swap);
+                case PlyType::Int32: return load_scalar<int32_t>(p, swap);
+                case PlyType::UInt32: return load_scalar<uint32_t>(p, swap);
+                case PlyType::Float32: return load_scalar<float>(p, swap);
+                case PlyType::Float64: return load_scalar<double>(p, swap);
+            }
+            return 0.0;
+        }
+
+        bool host_is_little_endian() {
+            const uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        // Разбирает одну строку ASCII PLY: координаты вершины или индексы грани
+        void parse_ply_ascii_vertex(const char*& p, const char* end, const PlyElement& element, int axes[3], Point3& vertex) {
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                const PlyProperty& property = element.properties[i];
+                if (property.is_list) {
+                    long long count = 0;
+                    if (!parse_integer(p, end, count)) throw std::runtime_error("PLY: некорректная строка вершины");
+                    for (long long k = 0; k < count; ++k) skip_token(p, end);
+                    continue;
+                }
+                double value = 0.0;
+                if (!parse_double(p, end, value)) throw std::runtime_error("PLY: некорректная строка вершины");
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (axes[axis] == static_cast<int>(i)) vertex[axis] = value;
+                }
+            }
+        }
+
+        void parse_ply_ascii_face(const char*& p, const char* end, const PlyElement& element, int list_index,
+                                  std::vector<long long>& polygon, std::vector<long long>& out) {
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                const PlyProperty& property = element.properties[i];
+                if (!property.is_list) {
+                    skip_token(p, end);
+                    continue;
+                }
+                long long count = 0;
+                if (!parse_integer(p, end, count)) throw std::runtime_error("PLY: некорректная строка грани");
+                if (static_cast<int>(i) != list_index) {
+                    for (long long k = 0; k < count; ++k) skip_token(p, end);
+                    continue;
+                }
+                polygon.clear();
+                for (long long k = 0; k < count; ++k) {
+                    long long index = 0;
+                    if (!parse_integer(p, end, index)) throw std::runtime_error("PLY: некорректная строка грани");
+                    polygon.push_back(index);
+                }
+                append_fan(polygon, out);
+            }
+        }
+
+        size_t ply_binary_record_size(const PlyElement& element, const char* p, const char* end, bool swap) {
+            size_t size = 0;
+            for (const auto& property : element.properties) {
+                if (!property.is_list) {
+                    size += ply_type_size(property.type);
+                    continue;
+                }
+                const size_t count_size = ply_type_size(property.count_type);
+                if (static_cast<size_t>(end - p) < size + count_size) throw std::runtime_error("PLY: файл обрезан");
+                const auto count = static_cast<size_t>(read_ply_binary(p + size, property.count_type, swap));
+                size += count_size + count * ply_type_size(property.type);
+            }
+            return size;
+        }
+    }
+
+    void weld_vertices(MeshData& mesh) {
+        const size_t count = mesh.vertices.size();
+        const size_t empty = static_cast<size_t>(-1);
+        size_t capacity = 16;
+        while (capacity < 2 * count) capacity <<= 1;
+        const size_t mask = capacity - 1;
+
+        auto bits = [](double value) {
+            value += 0.0;   // -0.0 и 0.0 считаются одной координатой
+            uint64_t result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        };
+
+        std::vector<size_t> slots(capacity, empty);
+        std::vector<size_t> remap(count);
+        std::vector<Point3> unique;
+        unique.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const Point3& v = mesh.vertices[i];
+            const uint64_t x = bits(v[0]), y = bits(v[1]), z = bits(v[2]);
+            uint64_t hash = x * 0x9E3779B97F4A7C15ull ^ y * 0xC2B2AE3D27D4EB4Full ^ z * 0x165667B19E3779F9ull;
+            hash ^= hash >> 29;
+            size_t slot = static_cast<size_t>(hash) & mask;
+            while (slots[slot] != empty) {
+                const Point3& u = unique[slots[slot]];
+                if (bits(u[0]) == x && bits(u[1]) == y && bits(u[2]) == z) break;
+                slot = (slot + 1) & mask;
+            }
+            if (slots[slot] == empty) {
+                slots[slot] = unique.size();
+                unique.push_back(v);
+            }
+            remap[i] = slots[slot];
+        }
+
+        for (auto& index : mesh.indices) {
+            index = remap[index];
+        }
+        unique.shrink_to_fit();
+        mesh.vertices = std::move(unique);
+    }
+
+    MeshData load_obj(const std::filesystem::path& path, StageScheduler* scheduler) {
+        MappedFile file(path);
+        const auto ranges = split_at_lines(file.begin(), file.end(), chunk_count(file.size(), scheduler));
+
+        std::vector<ObjChunk> chunks(ranges.size());
+        for_each_chunk(scheduler, ranges.size(), [&](size_t i) {
+            parse_obj_chunk(ranges[i].first, ranges[i].second, chunks[i]);
+        });
+
+        // Смещения вершин каждого куска нужны для отрицательных (относительных) индексов
+        std::vector<size_t> vertex_offsets(chunks.size() + 1, 0);
+        std::vector<size_t> index_offsets(chunks.size() + 1, 0);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            vertex_offsets[i + 1] = vertex_offsets[i] + chunks[i].vertices.size();
+            index_offsets[i + 1] = index_offsets[i] + chunks[i].faces.size();
+        }
+
+        MeshData mesh;
+        mesh.vertices.resize(vertex_offsets.back());
+        mesh.indices.resize(index_offsets.back());
+        const size_t vertex_count = vertex_offsets.back();
+        for_each_chunk(scheduler, chunks.size(), [&](size_t i) {
+            ObjChunk& chunk = chunks[i];
+            for (size_t position : chunk.relative) {
+                chunk.faces[position] += static_cast<long long>(vertex_offsets[i]);
+            }
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), mesh.vertices.begin() + vertex_offsets[i]);
+            for (size_t k = 0; k < chunk.faces.size(); ++k) {
+                mesh.indices[index_offsets[i] + k] = checked_index(chunk.faces[k], vertex_count);
+            }
+            std::vector<Point3>().swap(chunk.vertices);
+        });
+
+        weld_vertices(mesh);
+        return mesh;
+    }
+
+    MeshData load_stl(const std::filesystem::path& path, StageScheduler* scheduler) {
+        MappedFile file(path);
+        const char* data = file.data();
+        MeshData mesh;
+
+        bool binary = false;
+        size_t triangles = 0;
+        if (file.size() >= 84) {
+            triangles = load_scalar<uint32_t>(data + 80, !host_is_little_endian());
+            binary = 84 + 50 * triangles == file.size();
+        }
+
+        if (binary) {
+            const bool swap = !host_is_little_endian();
+            mesh.vertices.resize(3 * triangles);
+            const size_t block = 1 << 16;
+            const size_t blocks = (triangles + block - 1) / block;
+            for_each_chunk(scheduler, blocks, [&](size_t b) {
+                const size_t last = std::min(triangles, (b + 1) * block);
+                for (size_t t = b * block; t < last; ++t) {
+                    const char* record = data + 84 + 50 * t + 12;   // первые 12 байт - нормаль
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        const char* v = record + 12 * corner;
+                        mesh.vertices[3 * t + corner] = Point3(load_scalar<float>(v, swap),
+                                                               load_scalar<float>(v + 4, swap),
+                                                               load_scalar<float>(v + 8, swap));
+                    }
+                }
+            });
+        } else {
+            if (!starts_with(data, file.end(), "solid")) {
+                throw std::runtime_error("STL: неизвестный формат файла " + path.string());
+            }
+            const auto ranges = split_at_lines(file.begin(), file.end(), chunk_count(file.size(), scheduler));
+            std::vector<std::vector<Point3>> parts(ranges.size());
+            for_each_chunk(scheduler, ranges.size(), [&](size_t i) {
+                const char* p = ranges[i].first;
+                const char* end = ranges[i].second;
+                while (p < end) {
+                    const char* line_end = next_line(p, end);
+                    skip_blanks(p, line_end);
+                    if (starts_with(p, line_end, "vertex")) {
+                        p += 6;
+                        double x = 0, y = 0, z = 0;
+                        if (!parse_double(p, line_end, x) || !parse_double(p, line_end, y) || !parse_double(p, line_end, z)) {
+                            throw std::runtime_error("STL: некорректная вершина");
+                        }
+                        parts[i].emplace_back(x, y, z);
+                    }
+                    p = line_end;
+                }
+            });
+            mesh.vertices = concatenate(parts);
+            if (mesh.vertices.size() % 3 != 0) {
+                throw std::runtime_error("STL: число вершин не кратно трем");
+            }
+        }
+
+        mesh.indices.resize(mesh.vertices.size());
+        std::iota(mesh.indices.begin(), mesh.indices.end(), size_t(0));
+        weld_vertices(mesh);
+        return mesh;
+    }
+
+    MeshData load_ply(const std::filesystem::path& path, StageScheduler* scheduler) {
+        MappedFile file(path);
+        const char* p = file.begin();
+        const char* end = file.end();
+
+        if (!starts_with(p, end, "ply")) {
+            throw std::runtime_error("PLY: отсутствует сигнатура в файле " + path.string());
+        }
+
+        std::string format;
+        std::vector<PlyElement> elements;
+        for (p = next_line(p, end); ; p = next_line(p, end)) {
+            if (p >= end) throw std::runtime_error("PLY: не найден конец заголовка");
+            const char* line_end = next_line(p, end);
+            std::istringstream line(std::string(p, line_end));
+            std::string keyword;
+            line >> keyword;
+            if (keyword == "format") {
+                line >> format;
+            } else if (keyword == "element") {
+                PlyElement element;
+                line >> element.name >> element.count;
+                elements.push_back(element);
+            } else if (keyword == "property") {
+                if (elements.empty()) throw std::runtime_error("PLY: свойство вне элемента");
+                PlyProperty property;
+                std::string type;
+                line >> type;
+                if (type == "list") {
+                    std::string count_type, item_type;
+                    line >> count_type >> item_type;
+                    property.is_list = true;
+                    property.count_type = parse_ply_type(count_type);
+                    property.type = parse_ply_type(item_type);
+                } else {
+                    property.type = parse_ply_type(type);
+                }
+                line >> property.name;
+                elements.back().properties.push_back(property);
+            } else if (keyword == "end_header") {
+                p = line_end;
+                break;
+            }
+        }
+
+        const bool ascii = format == "ascii";
+        if (!ascii && format != "binary_little_endian" && format != "binary_big_endian") {
+            throw std::runtime_error("PLY: неподдерживаемый формат " + format);
+        }
+        const bool swap = !ascii && (format == "binary_little_endian") != host_is_little_endian();
+
+        MeshData mesh;
+        std::vector<long long> faces;
+        for (const PlyElement& element : elements) {
+            int axes[3] = {-1, -1, -1};
+            int list_index = -1;
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                const std::string& name = element.properties[i].name;
+                if (name == "x") axes[0] = static_cast<int>(i);
+                if (name == "y") axes[1] = static_cast<int>(i);
+                if (name == "z") axes[2] = static_cast<int>(i);
+                if (element.properties[i].is_list && (name == "vertex_indices" || name == "vertex_index")) {
+                    list_index = static_cast<int>(i);
+                }
+            }
+            const bool is_vertex = element.name == "vertex";
+            const bool is_face = element.name == "face" && list_index >= 0;
+
+            if (ascii) {
+                // Строки элемента находятся последовательно, затем разбираются кусками параллельно
+                const char* section = p;
+                for (size_t i = 0; i < element.count; ++i) {
+                    if (p >= end) throw std::runtime_error("PLY: файл обрезан");
+                    p = next_line(p, end);
+                }
+                if (!is_vertex && !is_face) continue;
+
+                const auto ranges = split_at_lines(section, p, chunk_count(static_cast<size_t>(p - section), scheduler));
+                if (is_vertex) {
+                    std::vector<std::vector<Point3>> parts(ranges.size());
+                    for_each_chunk(scheduler, ranges.size(), [&](size_t i) {
+                        for (const char* q = ranges[i].first; q < ranges[i].second; ) {
+                            const char* line_end = next_line(q, ranges[i].second);
+                            Point3 vertex;
+                            parse_ply_ascii_vertex(q, line_end, element, axes, vertex);
+                            parts[i].push_back(vertex);
+                            q = line_end;
+                        }
+                    });
+                    mesh.vertices = concatenate(parts);
+                } else {
+                    std::vector<std::vector<long long>> parts(ranges.size());
+                    for_each_chunk(scheduler, ranges.size(), [&](size_t i) {
+                        std::vector<long long> polygon;
+                        for (const char* q = ranges[i].first; q < ranges[i].second; ) {
+                            const char* line_end = next_line(q, ranges[i].second);
+                            parse_ply_ascii_face(q, line_end, element, list_index, polygon, parts[i]);
+                            q = line_end;
+                        }
+                    });
+                    faces = concatenate(parts);
+                }
+                continue;
+            }
+
+            const bool fixed_size = std::none_of(element.properties.begin(), element.properties.end(),
+                                                 [](const PlyProperty& property) { return property.is_list; });
+            if (is_vertex && fixed_size) {
+                std::vector<size_t> offsets;
+                size_t stride = 0;
+                for (const auto& property : element.properties) {
+                    offsets.push_back(stride);
+                    stride += ply_type_size(property.type);
+                }
+                if (static_cast<size_t>(end - p) < stride * element.count) throw std::runtime_error("PLY: файл обрезан");
+
+                mesh.vertices.resize(element.count);
+                const char* base = p;
+                const size_t block = 1 << 16;
+                for_each_chunk(scheduler, (element.count + block - 1) / block, [&](size_t b) {
+                    const size_t last = std::min(element.count, (b + 1) * block);
+                    for (size_t v = b * block; v < last; ++v) {
+                        const char* record = base + v * stride;
+                        Point3 vertex;
+                        for (int axis = 0; axis < 3; ++axis) {
+                            if (axes[axis] < 0) continue;
+                            vertex[axis] = read_ply_binary(record + offsets[axes[axis]], element.properties[axes[axis]].type, swap);
+                        }
+                        mesh.vertices[v] = vertex;
+                    }
+                });
+                p += stride * element.count;
+                continue;
+            }
+
+            // Записи переменной длины читаются последовательно
+            std::vector<long long> polygon;
+            if (is_vertex) mesh.vertices.reserve(element.count);
+            for (size_t r = 0; r < element.count; ++r) {
+                const size_t record_size = ply_binary_record_size(element, p, end, swap);
+                if (static_cast<size_t>(end - p) < record_size) throw std::runtime_error("PLY: файл обрезан");
+                const char* field = p;
+                Point3 vertex;
+                for (size_t i = 0; i < element.properties.size(); ++i) {
+                    const PlyProperty& property = element.properties[i];
+                    if (!property.is_list) {
+                        const double value = read_ply_binary(field, property.type, swap);
+                        for (int axis = 0; axis < 3; ++axis) {
+                            if (axes[axis] == static_cast<int>(i)) vertex[axis] = value;
+                        }
+                        field += ply_type_size(property.type);
+                        continue;
+                    }
+                    const auto count = static_cast<size_t>(read_ply_binary(field, property.count_type, swap));
+                    field += ply_type_size(property.count_type);
+                    if (is_face && static_cast<int>(i) == list_index) {
+                        polygon.clear();
+                        for (size_t k = 0; k < count; ++k) {
+                            polygon.push_back(static_cast<long long>(read_ply_binary(field + k * ply_type_size(property.type), property.type, swap)));
+                        }
+                        append_fan(polygon, faces);
+                    }
+                    field += count * ply_type_size(property.type);
+                }
+                if (is_vertex) mesh.vertices.push_back(vertex);
+                p += record_size;
+            }
+        }
+
+        mesh.indices.resize(faces.size());
+        for (size_t i = 0; i < faces.size(); ++i) {
+            mesh.indices[i] = checked_index(faces[i], mesh.vertices.size());
+        }
+        weld_vertices(mesh);
+        return mesh;
+    }
+
+    MeshData load_mesh(const std::filesystem::path& path, StageScheduler* scheduler) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (extension == ".obj") return load_obj(path, scheduler);
+        if (extension == ".stl") return load_stl(path, scheduler);
+        if (extension == ".ply") return load_ply(path, scheduler);
+        throw std::invalid_argument("Неподдерживаемый формат модели: " + extension);
+    }
+
+} // namespace Geometry3D
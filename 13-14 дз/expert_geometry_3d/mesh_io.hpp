@@ -0,0 +1,62 @@
+#ifndef MESH_IO_HPP
+#define MESH_IO_HPP
+
+#include "geometry3d.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Geometry3D
+{
+    struct MeshData
+    {
+        std::vector<Point<double, 3>> vertices;
+        std::vector<size_t> indices;
+    };
+
+    // Файл, отображенный в память только для чтения
+    class MappedFile
+    {
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void *file_ = nullptr;
+        void *mapping_ = nullptr;
+#else
+        int fd_ = -1;
+#endif
+
+        public:
+            explicit MappedFile(const std::filesystem::path &path);
+            ~MappedFile();
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            const char *data() const noexcept { return data_; }
+            size_t size() const noexcept { return size_; }
+            const char *begin() const noexcept { return data_; }
+            const char *end() const noexcept { return data_ + size_; }
+    };
+
+    // Объединяет вершины с одинаковыми координатами и переписывает индексы
+    void weld_vertices(MeshData &mesh);
+
+    // Без планировщика файл разбирается в одном потоке
+    MeshData load_obj(const std::filesystem::path &path, StageScheduler *scheduler = nullptr);
+    MeshData load_stl(const std::filesystem::path &path, StageScheduler *scheduler = nullptr);
+    MeshData load_ply(const std::filesystem::path &path, StageScheduler *scheduler = nullptr);
+
+    // Формат определяется по расширению: .obj, .stl или .ply
+    MeshData load_mesh(const std::filesystem::path &path, StageScheduler *scheduler = nullptr);
+
+    template <typename Box>
+    Box import_box(const std::filesystem::path &path, StageScheduler *scheduler = nullptr)
+    {
+        MeshData mesh = load_mesh(path, scheduler);
+        return Box(std::move(mesh.vertices), std::move(mesh.indices));
+    }
+
+} // namespace Geometry3D
+
+#endif // MESH_IO_HPP
@@ -0,0 +1,160 @@
+#include "mesh_reorder.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Geometry3D {
+
+    namespace {
+        // Раздвигает младшие 21 бит так, что между соседними битами остаются два нуля
+        inline uint64_t spread_bits(uint32_t value) {
+            uint64_t x = value & 0x1fffff;
+            x = (x | x << 32) & 0x1f00000000ffffULL;
+            x = (x | x << 16) & 0x1f0000ff0000ffULL;
+            x = (x | x << 8) & 0x100f00f00f00f00fULL;
+            x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+            x = (x | x << 2) & 0x1249249249249249ULL;
+            return x;
+        }
+
+        constexpr size_t radix_bits = 8;
+        constexpr size_t radix_buckets = size_t(1) << radix_bits;
+        constexpr size_t radix_block = 1 << 16;
+
+        template <typename Body>
+        void for_each_block(size_t blocks, StageScheduler* scheduler, Body&& body) {
+            if (scheduler && blocks > 1) {
+                scheduler->parallel_for(blocks, body);
+            } else {
+                for (size_t b = 0; b < blocks; ++b) body(b);
+            }
+        }
+    }
+
+    uint64_t morton_encode(uint32_t x, uint32_t y, uint32_t z) {
+        return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+    }
+
+    void radix_sort_keys(std::vector<uint64_t>& keys, std::vector<size_t>& values, StageScheduler* scheduler) {
+        if (keys.size() != values.size()) {
+            throw std::invalid_argument("Размеры ключей и значений не совпадают");
+        }
+        const size_t count = keys.size();
+        if (count < 2) return;
+
+        const size_t blocks = (count + radix_block - 1) / radix_block;
+        std::vector<std::array<size_t, radix_buckets>> histograms(blocks);
+        std::vector<uint64_t> key_buffer(count);
+        std::vector<size_t> value_buffer(count);
+
+        uint64_t all_bits = 0;
+        for (uint64_t key : keys) all_bits |= key;
+
+        for (size_t shift = 0; shift < 64; shift += radix_bits) {
+            // Проход по разряду, где у всех ключей нули, ничего не меняет
+            if (((all_bits >> shift) & (radix_buckets - 1)) == 0) continue;
+
+            for_each_block(blocks, scheduler, [&](size_t b) {
+                auto& histogram = histograms[b];
+                histogram.fill(0);
+                const size_t end = std::min(count, (b + 1) * radix_block);
+                for (size_t i = b * radix_block; i < end; ++i) {
+                    ++histogram[(keys[i] >> shift) & (radix_buckets - 1)];
+                }
+            });
+
+            // Смещение блока b в корзине d: все меньшие корзины плюс предыдущие блоки этой корзины
+            size_t offset = 0;
+            for (size_t digit = 0; digit < radix_buckets; ++digit) {
+                for (size_t b = 0; b < blocks; ++b) {
+                    const size_t bucket_count = histograms[b][digit];
+                    histograms[b][digit] = offset;
+                    offset += bucket_count;
+                }
+            }
+
+            for_each_block(blocks, scheduler, [&](size_t b) {
+                auto& positions = histograms[b];
+                const size_t end = std::min(count, (b + 1) * radix_block);
+                for (size_t i = b * radix_block; i < end; ++i) {
+                    const size_t target = positions[(keys[i] >> shift) & (radix_buckets - 1)]++;
+                    key_buffer[target] = keys[i];
+                    value_buffer[target] = values[i];
+                }
+            });
+
+            keys.swap(key_buffer);
+            values.swap(value_buffer);
+        }
+    }
+
+    void reorder_morton(MeshData& mesh, StageScheduler* scheduler) {
+        const size_t triangles = mesh.indices.size() / 3;
+        if (triangles < 2) return;
+
+        double lower[3], upper[3];
+        for (size_t k = 0; k < 3; ++k) {
+            lower[k] = std::numeric_limits<double>::infinity();
+            upper[k] = -std::numeric_limits<double>::infinity();
+        }
+        for (size_t index : mesh.indices) {
+            const auto& v = mesh.vertices[index];
+            for (size_t k = 0; k < 3; ++k) {
+                lower[k] = std::min(lower[k], v[k]);
+                upper[k] = std::max(upper[k], v[k]);
+            }
+        }
+
+        // Центроиды квантуются на решетку 2^21 по каждой оси внутри общего AABB
+        const double cells = double((1u << 21) - 1);
+        double scale[3];
+        for (size_t k = 0; k < 3; ++k) {
+            const double extent = upper[k] - lower[k];
+            scale[k] = extent > 0.0 ? cells / extent : 0.0;
+        }
+
+        std::vector<uint64_t> keys(triangles);
+        std::vector<size_t> order(triangles);
+        const size_t blocks = (triangles + radix_block - 1) / radix_block;
+        for_each_block(blocks, scheduler, [&](size_t b) {
+            const size_t end = std::min(triangles, (b + 1) * radix_block);
+            for (size_t t = b * radix_block; t < end; ++t) {
+                uint32_t cell[3];
+                for (size_t k = 0; k < 3; ++k) {
+                    const double centroid = (mesh.vertices[mesh.indices[3 * t]][k]
+                                          + mesh.vertices[mesh.indices[3 * t + 1]][k]
+                                          + mesh.vertices[mesh.indices[3 * t + 2]][k]) / 3.0;
+                    const double q = (centroid - lower[k]) * scale[k];
+                    cell[k] = static_cast<uint32_t>(std::clamp(q, 0.0, cells));
+                }
+                keys[t] = morton_encode(cell[0], cell[1], cell[2]);
+                order[t] = t;
+            }
+        });
+        radix_sort_keys(keys, order, scheduler);
+
+        const size_t unassigned = std::numeric_limits<size_t>::max();
+        std::vector<size_t> remap(mesh.vertices.size(), unassigned);
+        std::vector<Point<double, 3>> vertices;
+        vertices.reserve(mesh.vertices.size());
+        std::vector<size_t> indices(triangles * 3);
+        for (size_t i = 0; i < triangles; ++i) {
+            const size_t t = order[i];
+            for (size_t k = 0; k < 3; ++k) {
+                const size_t v = mesh.indices[3 * t + k];
+                if (remap[v] == unassigned) {
+                    remap[v] = vertices.size();
+                    vertices.push_back(mesh.vertices[v]);
+                }
+                indices[3 * i + k] = remap[v];
+            }
+        }
+        for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+            if (remap[v] == unassigned) vertices.push_back(mesh.vertices[v]);
+        }
+
+        mesh.vertices = std::move(vertices);
+        mesh.indices = std::move(indices);
+    }
+
+} // namespace Geometry3D
@@ -0,0 +1,36 @@
+#ifndef MESH_REORDER_HPP
+#define MESH_REORDER_HPP
+
+#include "geometry3d.hpp"
+#include "mesh_io.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Geometry3D
+{
+    // 63-битный код Мортона: по 21 биту на координату, биты x, y, z чередуются
+    uint64_t morton_encode(uint32_t x, uint32_t y, uint32_t z);
+
+    // Устойчивая LSD-сортировка по 8 бит за проход; values переставляются вместе с keys.
+    // Блоки гистограмм фиксированы, поэтому результат не зависит от числа потоков
+    void radix_sort_keys(std::vector<uint64_t> &keys, std::vector<size_t> &values,
+                         StageScheduler *scheduler = nullptr);
+
+    // Треугольники упорядочиваются по коду Мортона центроида, вершины перенумеровываются
+    // в порядке первого использования; неиспользуемые вершины идут в конце в прежнем порядке
+    void reorder_morton(MeshData &mesh, StageScheduler *scheduler = nullptr);
+
+    template <typename Box>
+    Box morton_ordered(const Box &box, StageScheduler *scheduler = nullptr)
+    {
+        const auto &vertices = box.get_vertices();
+        const auto &indices = box.get_indices();
+        MeshData mesh{std::vector<Point<double, 3>>(vertices.begin(), vertices.end()),
+                      std::vector<size_t>(indices.begin(), indices.end())};
+        reorder_morton(mesh, scheduler);
+        return Box(std::move(mesh.vertices), std::move(mesh.indices));
+    }
+
+} // namespace Geometry3D
+
+#endif // MESH_REORDER_HPP
@@ -0,0 +1,404 @@
+#include "mesh_simplify.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <stdexcept>
+
+namespace Geometry3D {
+
+    namespace {
+        using Vec3 = std::array<double, 3>;
+
+        inline Vec3 sub(const Vec3& a, const Vec3& b) {
+            return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+        }
+
+        inline Vec3 cross(const Vec3& a, const Vec3& b) {
+            return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        }
+
+        inline double dot(const Vec3& a, const Vec3& b) {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        // Симметричная матрица 4x4: a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+        struct Quadric
+        {
+            double m[10] = {};
+
+            static Quadric plane(const Vec3& normal, double d, double weight) {
+                Quadric q;
+                const double a = normal[0], b = normal[1], c = normal[2];
+                const double values[10] = {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+                for (size_t k = 0; k < 10; ++k) q.m[k] = values[k] * weight;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& other) {
+                for (size_t k = 0; k < 10; ++k) m[k] += other.m[k];
+                return *this;
+            }
+
+            double evaluate(const Vec3& p) const {
+                const double x = p[0], y = p[1], z = p[2];
+                return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x
+                     + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y
+                     + m[7] * z * z + 2.0 * m[8] * z + m[9];
+            }
+
+            // Точка минимума квадрики по правилу Крамера; false, если система вырождена
+            bool minimize(Vec3& out) const {
+                const Vec3 rows[3] = {{m[0], m[1], m[2]}, {m[1], m[4], m[5]}, {m[2], m[5], m[7]}};
+                const Vec3 rhs = {-m[3], -m[6], -m[8]};
+                const double det = determinant(rows[0], rows[1], rows[2]);
+                const double scale = std::fabs(m[0] * m[4] * m[7]);
+                if (det == 0.0 || std::fabs(det) <= 1e-10 * scale) return false;
+
+                for (size_t column = 0; column < 3; ++column) {
+                    Vec3 replaced[3] = {rows[0], rows[1], rows[2]};
+                    for (size_t row = 0; row < 3; ++row) replaced[row][column] = rhs[row];
+                    out[column] = determinant(replaced[0], replaced[1], replaced[2]) / det;
+                }
+                return std::isfinite(out[0]) && std::isfinite(out[1]) && std::isfinite(out[2]);
+            }
+
+            static double determinant(const Vec3& a, const Vec3& b, const Vec3& c) {
+                return dot(a, cross(b, c));
+            }
+        };
+
+        struct Candidate
+        {
+            double cost;
+            size_t v0;
+            size_t v1;
+            uint32_t version0;
+            uint32_t version1;
+            Vec3 target;
+
+            bool operator>(const Candidate& other) const { return cost > other.cost; }
+        };
+
+        // Состояние упрощения: треугольники и списки инцидентных треугольников в плоских массивах.
+        // Вершина v ссылается на refs_[ref_start_[v], ref_start_[v] + ref_count_[v]); после
+        // схлопывания новый список дописывается в конец refs_, старый остается мусором до compact_refs
+        class Simplifier
+        {
+            std::vector<Vec3> positions_;
+            std::vector<size_t> triangles_;
+            std::vector<char> triangle_removed_;
+            std::vector<Quadric> quadrics_;
+            std::vector<char> vertex_removed_;
+            std::vector<uint32_t> versions_;
+            std::vector<size_t> ref_start_;
+            std::vector<size_t> ref_count_;
+            std::vector<size_t> refs_;
+            std::vector<uint32_t> marks_;
+            uint32_t mark_ = 0;
+            std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue_;
+            size_t live_triangles_ = 0;
+            double max_cost_ = 0.0;
+
+            static constexpr double boundary_weight = 10.0;
+
+            const size_t* corners(size_t triangle) const { return &triangles_[3 * triangle]; }
+
+            Vec3 triangle_normal(size_t triangle, size_t moved, const Vec3& position) const {
+                const size_t* c = corners(triangle);
+                Vec3 p[3];
+                for (size_t k = 0; k < 3; ++k) p[k] = c[k] == moved ? position : positions_[c[k]];
+                return cross(sub(p[1], p[0]), sub(p[2], p[0]));
+            }
+
+            void compact_refs() {
+                std::fill(ref_count_.begin(), ref_count_.end(), 0);
+                for (size_t t = 0; t < triangle_removed_.size(); ++t) {
+                    if (triangle_removed_[t]) continue;
+                    for (size_t k = 0; k < 3; ++k) ++ref_count_[triangles_[3 * t + k]];
+                }
+                size_t offset = 0;
+                for (size_t v = 0; v < ref_count_.size(); ++v) {
+                    ref_start_[v] = offset;
+                    offset += ref_count_[v];
+                    ref_count_[v] = 0;
+                }
+                refs_.assign(offset, 0);
+                for (size_t t = 0; t < triangle_removed_.size(); ++t) {
+                    if (triangle_removed_[t]) continue;
+                    for (size_t k = 0; k < 3; ++k) {
+                        const size_t v = triangles_[3 * t + k];
+                        refs_[ref_start_[v] + ref_count_[v]++] = t;
+                    }
+                }
+            }
+
+            uint32_t next_mark() {
+                if (++mark_ == 0) {
+                    std::fill(marks_.begin(), marks_.end(), 0);
+                    mark_ = 1;
+                }
+                return mark_;
+            }
+
+            void push_candidate(size_t v0, size_t v1) {
+                Quadric q = quadrics_[v0];
+                q += quadrics_[v1];
+
+                Candidate candidate{0.0, v0, v1, versions_[v0], versions_[v1], {}};
+                if (q.minimize(candidate.target)) {
+                    candidate.cost = q.evaluate(candidate.target);
+                } else {
+                    const Vec3& a = positions_[v0];
+                    const Vec3& b = positions_[v1];
+                    const Vec3 options[3] = {a, b, {(a[0] + b[0]) * 0.5, (a[1] + b[1]) * 0.5, (a[2] + b[2]) * 0.5}};
+                    candidate.cost = std::numeric_limits<double>::infinity();
+                    for (const Vec3& option : options) {
+                        double cost = q.evaluate(option);
+                        if (cost < candidate.cost) {
+                            candidate.cost = cost;
+                            candidate.target = option;
+                        }
+                    }
+                }
+                candidate.cost = std::max(candidate.cost, 0.0);
+                queue_.push(candidate);
+            }
+
+            // Условие связности: общих соседей столько же, сколько общих треугольников,
+            // иначе схлопывание склеит сетку в неманифолд
+            bool link_condition(size_t v0, size_t v1) {
+                const uint32_t mark = next_mark();
+                for (size_t i = 0; i < ref_count_[v0]; ++i) {
+                    const size_t t = refs_[ref_start_[v0] + i];
+                    if (triangle_removed_[t]) continue;
+                    const size_t* c = corners(t);
+                    for (size_t k = 0; k < 3; ++k) marks_[c[k]] = mark;
+                }
+
+                size_t shared_triangles = 0;
+                const uint32_t common = next_mark();
+                size_t common_neighbours = 0;
+                for (size_t i = 0; i < ref_count_[v1]; ++i) {
+                    const size_t t = refs_[ref_start_[v1] + i];
+                    if (triangle_removed_[t]) continue;
+                    const size_t* c = corners(t);
+                    if (c[0] == v0 || c[1] == v0 || c[2] == v0) ++shared_triangles;
+                    for (size_t k = 0; k < 3; ++k) {
+                        const size_t n = c[k];
+                        if (n == v0 || n == v1) continue;
+                        if (marks_[n] == mark) {
+                            marks_[n] = common;
+                            ++common_neighbours;
+                        }
+                    }
+                }
+                return shared_triangles > 0 && common_neighbours == shared_triangles;
+            }
+
+            // Ни один оставшийся треугольник не должен выродиться или перевернуться
+            bool keeps_orientation(size_t moved, size_t other, const Vec3& target) const {
+                for (size_t i = 0; i < ref_count_[moved]; ++i) {
+                    const size_t t = refs_[ref_start_[moved] + i];
+                    if (triangle_removed_[t]) continue;
+                    const size_t* c = corners(t);
+                    if (c[0] == other || c[1] == other || c[2] == other) continue;
+
+                    const Vec3 before = triangle_normal(t, moved, positions_[moved]);
+                    const Vec3 after = triangle_normal(t, moved, target);
+                    const double length_before = std::sqrt(dot(before, before));
+                    const double length_after = std::sqrt(dot(after, after));
+                    if (length_after <= 1e-12 * length_before) return false;
+                    if (dot(before, after) < 0.2 * length_before * length_after) return false;
+                }
+                return true;
+            }
+
+            void collapse(const Candidate& candidate) {
+                const size_t v0 = candidate.v0;
+                const size_t v1 = candidate.v1;
+
+                positions_[v0] = candidate.target;
+                quadrics_[v0] += quadrics_[v1];
+                vertex_removed_[v1] = 1;
+                ++versions_[v0];
+                ++versions_[v1];
+                max_cost_ = std::max(max_cost_, candidate.cost);
+
+                const size_t start = refs_.size();
+                for (size_t vertex : {v0, v1}) {
+                    for (size_t i = 0; i < ref_count_[vertex]; ++i) {
+                        const size_t t = refs_[ref_start_[vertex] + i];
+                        if (triangle_removed_[t]) continue;
+                        size_t* c = &triangles_[3 * t];
+                        const bool has_v0 = c[0] == v0 || c[1] == v0 || c[2] == v0;
+                        const bool has_v1 = c[0] == v1 || c[1] == v1 || c[2] == v1;
+                        if (has_v0 && has_v1) {
+                            triangle_removed_[t] = 1;
+                            --live_triangles_;
+                            continue;
+                        }
+                        for (size_t k = 0; k < 3; ++k) {
+                            if (c[k] == v1) c[k] = v0;
+                        }
+                        refs_.push_back(t);
+                    }
+                }
+                ref_start_[v0] = start;
+                ref_count_[v0] = refs_.size() - start;
+                ref_count_[v1] = 0;
+
+                const uint32_t mark = next_mark();
+                marks_[v0] = mark;
+                for (size_t i = 0; i < ref_count_[v0]; ++i) {
+                    const size_t* c = corners(refs_[ref_start_[v0] + i]);
+                    for (size_t k = 0; k < 3; ++k) {
+                        if (marks_[c[k]] != mark) {
+                            marks_[c[k]] = mark;
+                            push_candidate(v0, c[k]);
+                        }
+                    }
+                }
+
+                if (refs_.size() > 4 * triangles_.size()) compact_refs();
+            }
+
+            // Плоскость через граничное ребро перпендикулярно прилегающему треугольнику
+            void add_boundary_quadric(size_t a, size_t b) {
+                for (size_t i = 0; i < ref_count_[a]; ++i) {
+                    const size_t t = refs_[ref_start_[a] + i];
+                    const size_t* c = corners(t);
+                    if (c[0] != b && c[1] != b && c[2] != b) continue;
+
+                    const Vec3 edge = sub(positions_[b], positions_[a]);
+                    const Vec3 face = triangle_normal(t, a, positions_[a]);
+                    Vec3 normal = cross(edge, face);
+                    const double length = std::sqrt(dot(normal, normal));
+                    if (length == 0.0) return;
+                    for (double& n : normal) n /= length;
+                    const Quadric q = Quadric::plane(normal, -dot(normal, positions_[a]), boundary_weight);
+                    quadrics_[a] += q;
+                    quadrics_[b] += q;
+                    return;
+                }
+            }
+
+            public:
+                explicit Simplifier(const MeshData& mesh) {
+                    positions_.reserve(mesh.vertices.size());
+                    for (const auto& v : mesh.vertices) positions_.push_back({v[0], v[1], v[2]});
+                    triangles_.assign(mesh.indices.begin(), mesh.indices.end() - mesh.indices.size() % 3);
+
+                    const size_t vertex_count = positions_.size();
+                    const size_t triangle_count = triangles_.size() / 3;
+                    triangle_removed_.assign(triangle_count, 0);
+                    quadrics_.assign(vertex_count, Quadric());
+                    vertex_removed_.assign(vertex_count, 0);
+                    versions_.assign(vertex_count, 0);
+                    ref_start_.assign(vertex_count, 0);
+                    ref_count_.assign(vertex_count, 0);
+                    marks_.assign(vertex_count, 0);
+
+                    std::vector<std::pair<size_t, size_t>> edges;
+                    edges.reserve(triangles_.size());
+                    for (size_t t = 0; t < triangle_count; ++t) {
+                        const size_t* c = corners(t);
+                        if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) {
+                            triangle_removed_[t] = 1;
+                            continue;
+                        }
+                        ++live_triangles_;
+
+                        Vec3 normal = cross(sub(positions_[c[1]], positions_[c[0]]), sub(positions_[c[2]], positions_[c[0]]));
+                        const double length = std::sqrt(dot(normal, normal));
+                        if (length > 0.0) {
+                            for (double& n : normal) n /= length;
+                            const Quadric q = Quadric::plane(normal, -dot(normal, positions_[c[0]]), 1.0);
+                            for (size_t k = 0; k < 3; ++k) quadrics_[c[k]] += q;
+                        }
+                        for (size_t k = 0; k < 3; ++k) {
+                            edges.emplace_back(std::min(c[k], c[(k + 1) % 3]), std::max(c[k], c[(k + 1) % 3]));
+                        }
+                    }
+                    compact_refs();
+
+                    std::sort(edges.begin(), edges.end());
+                    for (size_t i = 0; i < edges.size();) {
+                        size_t j = i;
+                        while (j < edges.size() && edges[j] == edges[i]) ++j;
+                        if (j - i == 1) add_boundary_quadric(edges[i].first, edges[i].second);
+                        i = j;
+                    }
+                    for (size_t i = 0; i < edges.size(); ++i) {
+                        if (i == 0 || edges[i] != edges[i - 1]) push_candidate(edges[i].first, edges[i].second);
+                    }
+                }
+
+                size_t live_triangles() const noexcept { return live_triangles_; }
+                double error() const { return std::sqrt(max_cost_); }
+
+                void run(size_t target_triangles, double max_error) {
+                    const double max_cost = max_error * max_error;
+                    while (live_triangles_ > target_triangles && !queue_.empty()) {
+                        const Candidate candidate = queue_.top();
+                        if (candidate.cost > max_cost) break;
+                        queue_.pop();
+
+                        if (vertex_removed_[candidate.v0] || vertex_removed_[candidate.v1]) continue;
+                        if (versions_[candidate.v0] != candidate.version0 || versions_[candidate.v1] != candidate.version1) continue;
+                        if (!link_condition(candidate.v0, candidate.v1)) continue;
+                        if (!keeps_orientation(candidate.v0, candidate.v1, candidate.target)) continue;
+                        if (!keeps_orientation(candidate.v1, candidate.v0, candidate.target)) continue;
+                        collapse(candidate);
+                    }
+                }
+
+                MeshData extract() const {
+                    MeshData result;
+                    std::vector<size_t> remap(positions_.size(), std::numeric_limits<size_t>::max());
+                    result.indices.reserve(live_triangles_ * 3);
+                    for (size_t t = 0; t < triangle_removed_.size(); ++t) {
+                        if (triangle_removed_[t]) continue;
+                        for (size_t k = 0; k < 3; ++k) {
+                            const size_t v = triangles_[3 * t + k];
+                            if (remap[v] == std::numeric_limits<size_t>::max()) {
+                                remap[v] = result.vertices.size();
+                                result.vertices.emplace_back(positions_[v][0], positions_[v][1], positions_[v][2]);
+                            }
+                            result.indices.push_back(remap[v]);
+                        }
+                    }
+                    return result;
+                }
+        };
+    }
+
+    MeshData simplify_mesh(const MeshData& mesh, size_t target_triangles, double max_error, double* achieved_error) {
+        Simplifier simplifier(mesh);
+        simplifier.run(target_triangles, max_error);
+        if (achieved_error) *achieved_error = simplifier.error();
+        return simplifier.extract();
+    }
+
+    std::vector<LodLevel> build_lod_chain(const MeshData& mesh, size_t levels, double ratio, double max_error) {
+        if (ratio <= 0.0 || ratio >= 1.0) {
+            throw std::invalid_argument("Коэффициент уменьшения должен быть в интервале (0, 1)");
+        }
+
+        std::vector<LodLevel> chain;
+        if (levels == 0) return chain;
+        chain.push_back({mesh, 0.0});
+
+        // Квадрики накапливаются от исходной сетки, поэтому ошибка уровня считается относительно оригинала
+        Simplifier simplifier(mesh);
+        while (chain.size() < levels) {
+            const size_t previous = simplifier.live_triangles();
+            const size_t target = static_cast<size_t>(static_cast<double>(previous) * ratio);
+            simplifier.run(target, max_error);
+            if (simplifier.live_triangles() == previous) break;
+            chain.push_back({simplifier.extract(), simplifier.error()});
+        }
+        return chain;
+    }
+
+} // namespace Geometry3D
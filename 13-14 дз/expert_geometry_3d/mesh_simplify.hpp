@@ -0,0 +1,45 @@
+#ifndef MESH_SIMPLIFY_HPP
+#define MESH_SIMPLIFY_HPP
+
+#include "geometry3d.hpp"
+#include "mesh_io.hpp"
+#include <limits>
+#include <vector>
+
+namespace Geometry3D
+{
+    struct LodLevel
+    {
+        MeshData mesh;
+        double error = 0.0;   // накопленная ошибка схлопываний в единицах длины
+    };
+
+    // Упрощение схлопыванием ребер по квадрикам (Garland–Heckbert) до target_triangles треугольников
+    // или до первой операции с ошибкой больше max_error. Сетка должна быть сварена (weld_vertices),
+    // граничные ребра сохраняются штрафными квадриками
+    MeshData simplify_mesh(const MeshData &mesh, size_t target_triangles,
+                           double max_error = std::numeric_limits<double>::infinity(),
+                           double *achieved_error = nullptr);
+
+    // Цепочка уровней детализации за один проход упрощения: уровень 0 - исходная сетка,
+    // каждый следующий примерно в ratio раз меньше предыдущего
+    std::vector<LodLevel> build_lod_chain(const MeshData &mesh, size_t levels, double ratio = 0.25,
+                                          double max_error = std::numeric_limits<double>::infinity());
+
+    template <typename Box>
+    std::vector<Box> build_box_lods(const Box &box, size_t levels, double ratio = 0.25)
+    {
+        const auto &vertices = box.get_vertices();
+        const auto &indices = box.get_indices();
+        MeshData mesh{std::vector<Point<double, 3>>(vertices.begin(), vertices.end()),
+                      std::vector<size_t>(indices.begin(), indices.end())};
+        std::vector<Box> lods;
+        for (LodLevel &level : build_lod_chain(mesh, levels, ratio)) {
+            lods.emplace_back(std::move(level.mesh.vertices), std::move(level.mesh.indices));
+        }
+        return lods;
+    }
+
+} // namespace Geometry3D
+
+#endif // MESH_SIMPLIFY_HPP
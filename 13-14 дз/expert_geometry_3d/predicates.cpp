@@ -0,0 +1,138 @@
+#include "predicates.hpp"
+#include <vector>
+
+namespace Geometry3D {
+
+    namespace {
+        // Разложение: неперекрывающиеся слагаемые по возрастанию модуля, без нулей.
+        // Сумма слагаемых равна значению точно, знак определяется последним слагаемым
+        using Expansion = std::vector<double>;
+
+        inline void two_sum(double a, double b, double& sum, double& error) {
+            sum = a + b;
+            const double b_virtual = sum - a;
+            const double a_virtual = sum - b_virtual;
+            error = (a - a_virtual) + (b - b_virtual);
+        }
+
+        inline void fast_two_sum(double a, double b, double& sum, double& error) {
+            sum = a + b;
+            error = b - (sum - a);
+        }
+
+        inline void two_product(double a, double b, double& product, double& error) {
+            product = a * b;
+            error = std::fma(a, b, -product);
+        }
+
+        Expansion difference(double a, double b) {
+            double sum, error;
+            two_sum(a, -b, sum, error);
+            Expansion result;
+            if (error != 0.0) result.push_back(error);
+            if (sum != 0.0 || result.empty()) result.push_back(sum);
+            return result;
+        }
+
+        Expansion grow(const Expansion& e, double b) {
+            Expansion result;
+            result.reserve(e.size() + 1);
+            double q = b;
+            for (double component : e) {
+                double error;
+                two_sum(q, component, q, error);
+                if (error != 0.0) result.push_back(error);
+            }
+            if (q != 0.0 || result.empty()) result.push_back(q);
+            return result;
+        }
+
+        Expansion add(const Expansion& e, const Expansion& f) {
+            Expansion result = e;
+            for (double component : f) {
+                if (component != 0.0) result = grow(result, component);
+            }
+            return result;
+        }
+
+        Expansion negate(Expansion e) {
+            for (double& component : e) component = -component;
+            return e;
+        }
+
+        Expansion scale(const Expansion& e, double b) {
+            Expansion result;
+            result.reserve(2 * e.size());
+            double q, error;
+            two_product(e[0], b, q, error);
+            if (error != 0.0) result.push_back(error);
+            for (size_t i = 1; i < e.size(); ++i) {
+                double product, product_error, sum;
+                two_product(e[i], b, product, product_error);
+                two_sum(q, product_error, sum, error);
+                if (error != 0.0) result.push_back(error);
+                fast_two_sum(product, sum, q, error);
+                if (error != 0.0) result.push_back(error);
+            }
+            if (q != 0.0 || result.empty()) result.push_back(q);
+            return result;
+        }
+
+        Expansion multiply(const Expansion& e, const Expansion& f) {
+            Expansion result{0.0};
+            for (double component : f) {
+                result = add(result, scale(e, component));
+            }
+            return result;
+        }
+
+        double estimate(const Expansion& e) {
+            double sum = 0.0;
+            for (double component : e) sum += component;
+            return sum;
+        }
+
+        // p * s - q * r для разложений
+        Expansion minor(const Expansion& p, const Expansion& s, const Expansion& q, const Expansion& r) {
+            return add(multiply(p, s), negate(multiply(q, r)));
+        }
+    }
+
+    namespace Predicates {
+
+        double orient2d_exact(const double* a, const double* b, const double* c) {
+            const Expansion acx = difference(a[0], c[0]), acy = difference(a[1], c[1]);
+            const Expansion bcx = difference(b[0], c[0]), bcy = difference(b[1], c[1]);
+            return estimate(minor(acx, bcy, acy, bcx));
+        }
+
+        double orient3d_exact(const double* a, const double* b, const double* c, const double* d) {
+            const Expansion adx = difference(a[0], d[0]), ady = difference(a[1], d[1]), adz = difference(a[2], d[2]);
+            const Expansion bdx = difference(b[0], d[0]), bdy = difference(b[1], d[1]), bdz = difference(b[2], d[2]);
+            const Expansion cdx = difference(c[0], d[0]), cdy = difference(c[1], d[1]), cdz = difference(c[2], d[2]);
+
+            Expansion det = multiply(adz, minor(bdx, cdy, cdx, bdy));
+            det = add(det, multiply(bdz, minor(cdx, ady, adx, cdy)));
+            det = add(det, multiply(cdz, minor(adx, bdy, bdx, ady)));
+            // Знак по соглашению orient3d: положителен со стороны нормали (b-a)x(c-a)
+            return -estimate(det);
+        }
+
+        double incircle_exact(const double* a, const double* b, const double* c, const double* d) {
+            const Expansion adx = difference(a[0], d[0]), ady = difference(a[1], d[1]);
+            const Expansion bdx = difference(b[0], d[0]), bdy = difference(b[1], d[1]);
+            const Expansion cdx = difference(c[0], d[0]), cdy = difference(c[1], d[1]);
+
+            const Expansion alift = add(multiply(adx, adx), multiply(ady, ady));
+            const Expansion blift = add(multiply(bdx, bdx), multiply(bdy, bdy));
+            const Expansion clift = add(multiply(cdx, cdx), multiply(cdy, cdy));
+
+            Expansion det = multiply(alift, minor(bdx, cdy, cdx, bdy));
+            det = add(det, multiply(blift, minor(cdx, ady, adx, cdy)));
+            det = add(det, multiply(clift, minor(adx, bdy, bdx, ady)));
+            return estimate(det);
+        }
+
+    } // namespace Predicates
+
+} // namespace Geometry3D
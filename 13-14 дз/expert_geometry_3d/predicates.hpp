@@ -0,0 +1,103 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <cmath>
+
+// Предикаты ориентации с фильтром по плавающей точке (Shewchuk): знак результата всегда точен.
+// Быстрый путь - обычный определитель и оценка погрешности; если знак не гарантирован,
+// определитель пересчитывается точно в арифметике разложений (expansion arithmetic).
+// Точки передаются любым типом с operator[]: Point<double, N>, double*, std::array
+namespace Geometry3D
+{
+    namespace Predicates
+    {
+        constexpr double epsilon = 1.1102230246251565e-16;   // 2^-53
+        constexpr double orient2d_bound = (3.0 + 16.0 * epsilon) * epsilon;
+        constexpr double orient3d_bound = (7.0 + 56.0 * epsilon) * epsilon;
+        constexpr double incircle_bound = (10.0 + 96.0 * epsilon) * epsilon;
+
+        double orient2d_exact(const double *a, const double *b, const double *c);
+        double orient3d_exact(const double *a, const double *b, const double *c, const double *d);
+        double incircle_exact(const double *a, const double *b, const double *c, const double *d);
+    }
+
+    // > 0, если a, b, c обходятся против часовой стрелки, 0 - если точки коллинеарны
+    template <typename P>
+    double orient2d(const P &a, const P &b, const P &c)
+    {
+        const double left = (a[0] - c[0]) * (b[1] - c[1]);
+        const double right = (a[1] - c[1]) * (b[0] - c[0]);
+        const double det = left - right;
+        const double bound = Predicates::orient2d_bound * (std::fabs(left) + std::fabs(right));
+        if (det > bound || -det > bound) return det;
+
+        const double pa[2] = {a[0], a[1]}, pb[2] = {b[0], b[1]}, pc[2] = {c[0], c[1]};
+        return Predicates::orient2d_exact(pa, pb, pc);
+    }
+
+    // > 0, если d лежит с той стороны плоскости abc, куда смотрит нормаль (b-a)x(c-a)
+    template <typename P>
+    double orient3d(const P &a, const P &b, const P &c, const P &d)
+    {
+        const double adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+        const double bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+        const double cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+
+        const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        const double cdxady = cdx * ady, adxcdy = adx * cdy;
+        const double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+        const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+        const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * std::fabs(adz)
+                               + (std::fabs(cdxady) + std::fabs(adxcdy)) * std::fabs(bdz)
+                               + (std::fabs(adxbdy) + std::fabs(bdxady)) * std::fabs(cdz);
+        const double bound = Predicates::orient3d_bound * permanent;
+        if (det > bound || -det > bound) return -det;
+
+        const double pa[3] = {a[0], a[1], a[2]}, pb[3] = {b[0], b[1], b[2]};
+        const double pc[3] = {c[0], c[1], c[2]}, pd[3] = {d[0], d[1], d[2]};
+        return Predicates::orient3d_exact(pa, pb, pc, pd);
+    }
+
+    // > 0, если d внутри окружности через a, b, c (обход против часовой стрелки)
+    template <typename P>
+    double incircle(const P &a, const P &b, const P &c, const P &d)
+    {
+        const double adx = a[0] - d[0], ady = a[1] - d[1];
+        const double bdx = b[0] - d[0], bdy = b[1] - d[1];
+        const double cdx = c[0] - d[0], cdy = c[1] - d[1];
+
+        const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        const double cdxady = cdx * ady, adxcdy = adx * cdy;
+        const double adxbdy = adx * bdy, bdxady = bdx * ady;
+        const double alift = adx * adx + ady * ady;
+        const double blift = bdx * bdx + bdy * bdy;
+        const double clift = cdx * cdx + cdy * cdy;
+
+        const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+        const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift
+                               + (std::fabs(cdxady) + std::fabs(adxcdy)) * blift
+                               + (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+        const double bound = Predicates::incircle_bound * permanent;
+        if (det > bound || -det > bound) return det;
+
+        const double pa[2] = {a[0], a[1]}, pb[2] = {b[0], b[1]};
+        const double pc[2] = {c[0], c[1]}, pd[2] = {d[0], d[1]};
+        return Predicates::incircle_exact(pa, pb, pc, pd);
+    }
+
+    // Треугольник вырожден, если все три его проекции на координатные плоскости вырождены
+    template <typename P>
+    bool is_degenerate_triangle(const P &a, const P &b, const P &c)
+    {
+        const double xy[3][2] = {{a[0], a[1]}, {b[0], b[1]}, {c[0], c[1]}};
+        const double yz[3][2] = {{a[1], a[2]}, {b[1], b[2]}, {c[1], c[2]}};
+        const double zx[3][2] = {{a[2], a[0]}, {b[2], b[0]}, {c[2], c[0]}};
+        return orient2d(xy[0], xy[1], xy[2]) == 0.0
+            && orient2d(yz[0], yz[1], yz[2]) == 0.0
+            && orient2d(zx[0], zx[1], zx[2]) == 0.0;
+    }
+
+} // namespace Geometry3D
+
+#endif // PREDICATES_HPP
@@ -0,0 +1,55 @@
+#include "render_loop.hpp"
+#include <exception>
+#include <iostream>
+
+namespace Geometry3D {
+
+    RenderLoop::RenderLoop(std::chrono::milliseconds frame_interval) : frame_interval_(frame_interval) {
+
+    }
+
+    RenderLoop::~RenderLoop() {
+        stop();
+    }
+
+    void RenderLoop::start(std::function<void()> frame) {
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = std::thread(&RenderLoop::run, this, std::move(frame));
+    }
+
+    void RenderLoop::stop() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void RenderLoop::run(std::function<void()> frame) {
+        using clock = std::chrono::steady_clock;
+        auto window_start = clock::now();
+        size_t frames = 0;
+
+        while (running_.load(std::memory_order_relaxed)) {
+            const auto frame_start = clock::now();
+            try {
+                frame();
+            } catch (const std::exception& e) {
+                std::cerr << "Ошибка отрисовки кадра: " << e.what() << std::endl;
+            }
+            ++frames;
+
+            const auto now = clock::now();
+            const double elapsed = std::chrono::duration<double>(now - window_start).count();
+            if (elapsed >= 1.0) {
+                fps_.store(frames / elapsed, std::memory_order_relaxed);
+                frames = 0;
+                window_start = now;
+            }
+            std::this_thread::sleep_until(frame_start + frame_interval_);
+        }
+        fps_.store(0.0, std::memory_order_relaxed);
+    }
+
+} // namespace Geometry3D
@@ -0,0 +1,69 @@
+#ifndef RENDER_LOOP_HPP
+#define RENDER_LOOP_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace Geometry3D
+{
+    // Тройной буфер без блокировок для одного писателя и одного читателя.
+    // Писатель заполняет back() и вызывает publish(), читатель забирает последний
+    // опубликованный слот через acquire(); ни одна сторона не ждет другую
+    template <typename T>
+    class TripleBuffer
+    {
+        static constexpr uint8_t index_mask = 0x3;
+        static constexpr uint8_t dirty_flag = 0x4;
+
+        T slots_[3];
+        alignas(64) std::atomic<uint8_t> middle_{1};
+        alignas(64) uint8_t back_ = 0;
+        alignas(64) uint8_t front_ = 2;
+
+        public:
+            T &back() noexcept { return slots_[back_]; }
+
+            void publish() noexcept {
+                back_ = middle_.exchange(static_cast<uint8_t>(back_ | dirty_flag), std::memory_order_acq_rel) & index_mask;
+            }
+
+            // true, если с прошлого вызова был опубликован новый слот
+            bool acquire() noexcept {
+                if (!(middle_.load(std::memory_order_relaxed) & dirty_flag)) return false;
+                front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+                return true;
+            }
+
+            const T &front() const noexcept { return slots_[front_]; }
+    };
+
+    // Поток отрисовки: вызывает frame() с заданным интервалом, пока не остановлен
+    class RenderLoop
+    {
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+        std::atomic<double> fps_{0.0};
+        std::chrono::milliseconds frame_interval_;
+
+        void run(std::function<void()> frame);
+
+        public:
+            explicit RenderLoop(std::chrono::milliseconds frame_interval = std::chrono::milliseconds(16));
+            ~RenderLoop();
+
+            RenderLoop(const RenderLoop &) = delete;
+            RenderLoop &operator=(const RenderLoop &) = delete;
+
+            void start(std::function<void()> frame);
+            void stop();
+
+            bool running() const noexcept { return running_.load(std::memory_order_relaxed); }
+            double fps() const noexcept { return fps_.load(std::memory_order_relaxed); }
+    };
+
+} // namespace Geometry3D
+
+#endif // RENDER_LOOP_HPP
@@ -120,23 +120,6 @@ void write_students_to_file(const std::string& filename, const std::vector<Stude
     output_file.close();
 }
 
-void write_students_to_file(const std::string& filename, const std::vector<Student>& students, bool only_passed) {
-    std::ofstream output_file(filename);
-    
-    if (!output_file.is_open()) {
-        std::cerr << "Ошибка: не удалось создать файл " << filename << std::endl;
-        return;
-    }
-    
-    for (const auto& student : students) {
-        if (!only_passed || student.passed_race()) {
-            student.write_to_file(output_file);
-        }
-    }
-    
-    output_file.close();
-}
-
 void display_students(const std::vector<Student>& students) {
     if (students.empty()) {
         std::cout << "Список студентов пуст." << std::endl;
@@ -156,56 +139,154 @@ void display_students(const std::vector<Student>& students) {
     }
 }
 
-void display_students(const std::vector<Student>& students, bool show_passed) {
-    if (students.empty()) {
-        std::cout << "Список студентов пуст." << std::endl;
-        return;
+// ========== ВЫБОРКИ БЕЗ КОПИРОВАНИЯ ==========
+
+// Выборка хранит только индексы подходящих студентов в исходном векторе,
+// исходный вектор должен жить дольше выборки
+struct StudentView {
+    const std::vector<Student>* source;
+    std::vector<size_t> indices;
+
+    explicit StudentView(const std::vector<Student>& students) : source(&students) {}
+
+    size_t size() const {
+        return indices.size();
     }
-    
-    std::cout << "\n=== СПИСОК СТУДЕНТОВ (" 
-                << (show_passed ? "СДАЛИ" : "НЕ СДАЛИ") 
-                << ") ===" << std::endl;
-    std::cout << std::left;
-    std::cout << std::setw(25) << "ФИО";
-    std::cout << std::setw(8) << "Курс";
-    std::cout << std::setw(10) << "Группа";
-    std::cout << "Результат забега" << std::endl;
-    std::cout << std::string(70, '-') << std::endl;
-    
-    size_t count = 0;
-    for (const auto& student : students) {
-        if (student.passed_race() == show_passed) {
-            student.display();
-            ++count;
+
+    bool empty() const {
+        return indices.empty();
+    }
+
+    const Student& operator[](size_t i) const {
+        return (*source)[indices[i]];
+    }
+};
+
+bool passed_race_filter(const Student& student) {
+    return student.passed_race();
+}
+
+bool failed_race_filter(const Student& student) {
+    return !student.passed_race();
+}
+
+bool course_filter(const Student& student, int course) {
+    return student.course == course;
+}
+
+auto course_equals(int course) {
+    return [course](const Student& student) {
+        return student.course == course;
+    };
+}
+
+auto group_starts_with(const std::string& prefix) {
+    return [prefix](const Student& student) {
+        return student.group.compare(0, prefix.size(), prefix) == 0;
+    };
+}
+
+// Объединение условий по И: все проверки выполняются за один проход
+// по студенту и обрываются на первом несовпадении
+template<typename... Predicates>
+auto all_of_filters(Predicates... predicates) {
+    return [=](const Student& student) {
+        return (predicates(student) && ...);
+    };
+}
+
+template<typename FilterFunc>
+StudentView select_students(const std::vector<Student>& students, FilterFunc filter) {
+    StudentView view(students);
+    for (size_t i = 0; i < students.size(); ++i) {
+        if (filter(students[i])) {
+            view.indices.push_back(i);
         }
     }
-    
-    if (count == 0) {
-        std::cout << "Нет студентов в этой категории." << std::endl;
+    return view;
+}
+
+// Сужение уже готовой выборки: просматриваются только ее элементы
+template<typename FilterFunc>
+StudentView select_students(const StudentView& view, FilterFunc filter) {
+    StudentView result(*view.source);
+    for (size_t index : view.indices) {
+        if (filter((*view.source)[index])) {
+            result.indices.push_back(index);
+        }
+    }
+    return result;
+}
+
+// Разбиение на сдавших и не сдавших за один проход
+void split_by_race(const std::vector<Student>& students, StudentView& passed, StudentView& failed) {
+    passed = StudentView(students);
+    failed = StudentView(students);
+    for (size_t i = 0; i < students.size(); ++i) {
+        (students[i].passed_race() ? passed : failed).indices.push_back(i);
     }
 }
 
 template<typename FilterFunc>
 std::vector<Student> filter_students(const std::vector<Student>& students, FilterFunc filter) {
+    StudentView view = select_students(students, filter);
     std::vector<Student> result;
-    for (const auto& student : students) {
-        if (filter(student)) {
-            result.push_back(student);
-        }
+    result.reserve(view.size());
+    for (size_t i = 0; i < view.size(); ++i) {
+        result.push_back(view[i]);
     }
     return result;
 }
 
-bool passed_race_filter(const Student& student) {
-    return student.passed_race();
+void write_students_to_file(const std::string& filename, const StudentView& view) {
+    std::ofstream output_file(filename);
+    
+    if (!output_file.is_open()) {
+        std::cerr << "Ошибка: не удалось создать файл " << filename << std::endl;
+        return;
+    }
+    
+    for (size_t i = 0; i < view.size(); ++i) {
+        view[i].write_to_file(output_file);
+    }
+    
+    output_file.close();
 }
 
-bool failed_race_filter(const Student& student) {
-    return !student.passed_race();
+void write_students_to_file(const std::string& filename, const std::vector<Student>& students, bool only_passed) {
+    if (!only_passed) {
+        write_students_to_file(filename, students);
+        return;
+    }
+    write_students_to_file(filename, select_students(students, passed_race_filter));
 }
 
-bool course_filter(const Student& student, int course) {
-    return student.course == course;
+void display_students(const StudentView& view, const std::string& title) {
+    if (view.source->empty()) {
+        std::cout << "Список студентов пуст." << std::endl;
+        return;
+    }
+    
+    std::cout << "\n=== СПИСОК СТУДЕНТОВ (" << title << ") ===" << std::endl;
+    std::cout << std::left;
+    std::cout << std::setw(25) << "ФИО";
+    std::cout << std::setw(8) << "Курс";
+    std::cout << std::setw(10) << "Группа";
+    std::cout << "Результат забега" << std::endl;
+    std::cout << std::string(70, '-') << std::endl;
+    
+    for (size_t i = 0; i < view.size(); ++i) {
+        view[i].display();
+    }
+    
+    if (view.empty()) {
+        std::cout << "Нет студентов в этой категории." << std::endl;
+    }
+}
+
+void display_students(const std::vector<Student>& students, bool show_passed) {
+    display_students(select_students(students, show_passed ? passed_race_filter : failed_race_filter),
+                     show_passed ? "СДАЛИ" : "НЕ СДАЛИ");
 }
 
 // ========== ГЛАВНАЯ ФУНКЦИЯ ==========
@@ -245,21 +326,27 @@ int main() {
     
     display_students(all_students);
     
-    display_students(all_students, true);
+    StudentView passed_students(all_students);
+    StudentView failed_students(all_students);
+    split_by_race(all_students, passed_students, failed_students);
+    
+    display_students(passed_students, "СДАЛИ");
     
-    display_students(all_students, false);
+    display_students(failed_students, "НЕ СДАЛИ");
     
-    std::vector<Student> passed_students = filter_students(all_students, passed_race_filter);
+    StudentView second_course_passed = select_students(all_students,
+        all_of_filters(passed_race_filter, course_equals(2), group_starts_with("ИСП-2")));
+    display_students(second_course_passed, "СДАЛИ, 2 КУРС, ИСП-2");
     
     std::cout << "\nЗапись студентов, сдавших норматив, в файл " << OUTPUT_FILE << "..." << std::endl;
-    write_students_to_file(OUTPUT_FILE, all_students, true);
+    write_students_to_file(OUTPUT_FILE, passed_students);
     
     std::cout << "\n==========================================" << std::endl;
     std::cout << "   ОТЧЕТ:" << std::endl;
     std::cout << "==========================================" << std::endl;
     std::cout << "Всего студентов: " << all_students.size() << std::endl;
     std::cout << "Сдали норматив: " << passed_students.size() << std::endl;
-    std::cout << "Не сдали норматив: " << all_students.size() - passed_students.size() << std::endl;
+    std::cout << "Не сдали норматив: " << failed_students.size() << std::endl;
     std::cout << "Результаты сохранены в файл: " << OUTPUT_FILE << std::endl;
     std::cout << "==========================================" << std::endl;
     